@@ -50,6 +50,36 @@ extern "C" {
  */
 int semver_cmp(const char *a, const char *b, int *res);
 
+/**
+ * semver_allocator
+ *
+ * routes all memory management of the library. Each function receives the
+ * user pointer as its first argument. malloc_fn and realloc_fn return NULL
+ * if out of memory, constructors then return NULL or a wrapped
+ * SEMVER_ERROR_OUT_OF_MEMORY.
+ */
+typedef struct {
+  void *(*malloc_fn)(void *user, size_t size);
+  void *(*realloc_fn)(void *user, void *ptr, size_t size);
+  void (*free_fn)(void *user, void *ptr);
+  void *user;
+} semver_allocator;
+
+/**
+ * semver_set_allocator replaces the allocator used by the library, the
+ * allocator struct is copied. NULL restores the default (malloc, realloc,
+ * free). Must be called before any object is constructed, or after all of
+ * them have been released. Not thread-safe.
+ * @param[in] allocator allocator to use, or NULL
+ */
+void semver_set_allocator(const semver_allocator *allocator);
+
+/**
+ * semver_get_allocator copies the allocator currently in use.
+ * @param[out] allocator
+ */
+void semver_get_allocator(semver_allocator *allocator);
+
 /**
  * semver_version
  *
@@ -59,6 +89,13 @@ int semver_cmp(const char *a, const char *b, int *res);
 struct semver_version;
 typedef struct semver_version *semver_version;
 
+/**
+ * semver_arena is a bump-pointer allocator for bulk construction, see
+ * semverarena.h
+ */
+struct semver_arena;
+typedef struct semver_arena *semver_arena;
+
 /** semver_version_codes provides parsing error codes */
 typedef enum {
   /** successful parsing */
@@ -70,7 +107,13 @@ typedef enum {
   /** found a character that is not allowed at current position. See spec */
   SEMVER_ERROR_PARSE_NOT_ALLOWED_HERE = 12,
   /** found a structural error */
-  SEMVER_ERROR_STRUCTURE = 13
+  SEMVER_ERROR_STRUCTURE = 13,
+  /** memory could not be allocated */
+  SEMVER_ERROR_OUT_OF_MEMORY = 14,
+  /** a numeric component exceeds the range of unsigned long */
+  SEMVER_ERROR_PARSE_OVERFLOW = 15,
+  /** reading or writing a file failed, see errno */
+  SEMVER_ERROR_IO = 16
 } semver_version_codes;
 
 /** semver_version_wrapped is a wrapped return value for struct creation
@@ -86,6 +129,32 @@ typedef struct {
 /** maximum length of a parseable semver string */
 #define SEMVER_MAXLEN 255
 
+/**
+ * size in bytes of caller-provided storage for a semver_version, see
+ * semver_version_init_from_string. Prerelease and build parts that do not fit
+ * are kept in a separately allocated block.
+ */
+#define SEMVER_VERSION_STORAGE_SIZE 128
+
+/**
+ * required alignment of caller-provided storage. semver_version_storage
+ * is suitably aligned.
+ */
+#define SEMVER_STORAGE_ALIGN 8
+
+/**
+ * semver_version_storage is caller-provided memory for a semver_version, e.g.
+ * on the stack or as an array element. Contents are opaque. An initialized
+ * storage may be moved with memcpy, as long as only one copy is used and
+ * destroyed afterwards.
+ */
+typedef union {
+  unsigned char bytes[SEMVER_VERSION_STORAGE_SIZE];
+  unsigned long align_ul;
+  void *align_p;
+  double align_d;
+} semver_version_storage;
+
 /**
  * semver_version_new creates a new semver_version struct, initialized from
  * arguments strings can be null or are duplicated otherwise. empty strings are
@@ -121,6 +190,24 @@ semver_version semver_version_from_string(const char *s);
  */
 semver_version_wrapped semver_version_from_string_wrapped(const char *s);
 
+/**
+ * semver_version_from_strn parses a version from the first len bytes of buf,
+ * which need not be NUL-terminated, e.g. a slice of a larger buffer. Input is
+ * not copied. A NUL byte within len is a parse error.
+ * Must use semver_version_delete to free space.
+ * @param[in] buf version input
+ * @param[in] len number of bytes to parse
+ * @return pointer to allocated server_version struct
+ */
+semver_version semver_version_from_strn(const char *buf, size_t len);
+
+/**
+ * semver_version_from_strn_wrapped is identical to the variant above but
+ * returns a wrapped response including error codes.
+ */
+semver_version_wrapped semver_version_from_strn_wrapped(const char *buf,
+                                                        size_t len);
+
 /**
  * semver_version_from_copy allocates a new semver_version struct and copies
  * the contents from given struct.
@@ -131,10 +218,95 @@ semver_version semver_version_from_copy(const semver_version v);
 
 /**
  * semver_version_delete deletes optionally allocated memory, and delete self
+ * For versions in caller-provided storage, this is the same as
+ * semver_version_destroy.
  * @param[in] self semver_version struct to delete
  */
 void semver_version_delete(semver_version self);
 
+/**
+ * semver_version_*_in are the constructors from above, allocating from
+ * an arena instead of the heap. Returned versions are released with the
+ * arena, see semverarena.h.
+ */
+semver_version semver_version_from_in(semver_arena arena, unsigned long major,
+                                      unsigned long minor, unsigned long patch,
+                                      const char *prerelease,
+                                      const char *build);
+semver_version semver_version_from_string_in(semver_arena arena,
+                                             const char *s);
+semver_version_wrapped semver_version_from_string_wrapped_in(semver_arena arena,
+                                                             const char *s);
+semver_version semver_version_from_strn_in(semver_arena arena,
+                                           const char *buf, size_t len);
+semver_version_wrapped semver_version_from_strn_wrapped_in(semver_arena arena,
+                                                           const char *buf,
+                                                           size_t len);
+semver_version semver_version_from_copy_in(semver_arena arena,
+                                           const semver_version v);
+
+/**
+ * semver_version_init_from_string parses a given semver string into
+ * caller-provided storage. Does not allocate memory unless prerelease and
+ * build parts exceed the storage. Returns NULL in case the given string could
+ * not be parsed correctly, a version pointing into mem otherwise.
+ * Must use semver_version_destroy to release it.
+ * @param[in] mem storage to initialize
+ * @param[in] s version input string
+ * @return pointer to initialized semver_version struct
+ */
+semver_version semver_version_init_from_string(semver_version_storage *mem,
+                                               const char *s);
+
+/**
+ * semver_version_init_from_string_wrapped is identical to the variant above
+ * but returns a wrapped response including error codes.
+ * @param[in] mem storage to initialize
+ * @param[in] s version input string
+ * @return wrapped result struct, including error handling
+ */
+semver_version_wrapped
+semver_version_init_from_string_wrapped(semver_version_storage *mem,
+                                        const char *s);
+
+/**
+ * semver_version_init_from_strn(_wrapped) are the length-delimited variants
+ * of the two above, see semver_version_from_strn.
+ */
+semver_version semver_version_init_from_strn(semver_version_storage *mem,
+                                             const char *buf, size_t len);
+semver_version_wrapped
+semver_version_init_from_strn_wrapped(semver_version_storage *mem,
+                                      const char *buf, size_t len);
+
+/**
+ * semver_version_init_from initializes a version in caller-provided storage
+ * from given arguments, see semver_version_from.
+ * Must use semver_version_destroy to release it.
+ */
+semver_version semver_version_init_from(semver_version_storage *mem,
+                                        unsigned long major,
+                                        unsigned long minor,
+                                        unsigned long patch,
+                                        const char *prerelease,
+                                        const char *build);
+
+/**
+ * semver_version_init_from_copy initializes a version in caller-provided
+ * storage with the contents of given version.
+ * Must use semver_version_destroy to release it.
+ * @return pointer to initialized semver_version struct. Returns 0 if 0 is given.
+ */
+semver_version semver_version_init_from_copy(semver_version_storage *mem,
+                                             const semver_version v);
+
+/**
+ * semver_version_destroy releases memory held by a version in
+ * caller-provided storage. The storage itself is not freed.
+ * @param[in] self semver_version struct to destroy
+ */
+void semver_version_destroy(semver_version self);
+
 /**
  * semver_version_get_* retrieves a field from the data set, see SEMVER_FIELD_*
  */
@@ -206,6 +378,97 @@ size_t semver_version_sprint(const semver_version self, char *str);
  */
 int semver_version_cmp(const semver_version a, const semver_version b);
 
+/**
+ * semver_version_key is a packed ordering key of a version: hi holds the
+ * major version, lo holds minor and patch versions and a bit that is set for
+ * versions without prerelease. Comparing keys orders versions like
+ * semver_version_cmp, except that versions differing only in their
+ * prerelease, or in minor or patch values too large for the packed fields,
+ * have equal keys. Compare the versions themselves in that case, see
+ * semver_version_cmp_keyed.
+ */
+typedef struct {
+  unsigned long hi;
+  unsigned long lo;
+} semver_version_key;
+
+/**
+ * semver_version_key_of computes the ordering key of a version.
+ * @param[in] self semver_version, != NULL
+ * @return packed ordering key
+ */
+semver_version_key semver_version_key_of(const semver_version self);
+
+/**
+ * semver_version_key_cmp compares two ordering keys
+ * @return -1, 0 or 1 if a is less than, equal to or greater than b
+ */
+int semver_version_key_cmp(const semver_version_key *a,
+                           const semver_version_key *b);
+
+/**
+ * semver_version_cmp_keyed compares two versions given with their keys,
+ * which must have been computed by semver_version_key_of. Falls back to
+ * semver_version_cmp only if the keys are equal.
+ * @return <0, 0, >0 if a is less than, equal to or greater than b
+ */
+int semver_version_cmp_keyed(const semver_version a,
+                             const semver_version_key *ka,
+                             const semver_version b,
+                             const semver_version_key *kb);
+
+/**
+ * semver_version_hash returns a hash value of a version that is consistent
+ * with semver_version_cmp: versions comparing equal have equal hashes. Build
+ * metadata is ignored. Hash values are not stable across platforms or
+ * library versions, do not persist them.
+ * @param[in] self semver_version, != NULL
+ * @return hash value
+ */
+unsigned long semver_version_hash(const semver_version self);
+
+/**
+ * semver_version_hash_exact is semver_version_hash including build metadata,
+ * e.g. to tell "1.0.0+a" from "1.0.0+b".
+ * @param[in] self semver_version, != NULL
+ * @return hash value
+ */
+unsigned long semver_version_hash_exact(const semver_version self);
+
+/** flag for semver_version_collation_key: append build metadata */
+#define SEMVER_COLLATE_WITH_BUILD 1
+
+/** upper bound of the length of a collation key */
+#define SEMVER_COLLATION_KEY_MAXLEN (2 * SEMVER_MAXLEN + 32)
+
+/**
+ * semver_version_collation_key encodes a version into a byte string whose
+ * memcmp order is semver precedence, e.g. for byte-ordered indexes. Versions
+ * of equal precedence have equal keys, unless SEMVER_COLLATE_WITH_BUILD is
+ * given: build metadata is then appended, ordering equal versions by their
+ * build bytes. Numeric prerelease identifiers are stored without leading
+ * zeros, and an empty prerelease ("1.0.0-") like none.
+ * @param[in] self semver_version, != NULL
+ * @param[in] flags 0 or SEMVER_COLLATE_WITH_BUILD
+ * @param[out] buf target buffer, may be NULL if size is 0
+ * @param[in] size size of buf, at most SEMVER_COLLATION_KEY_MAXLEN needed
+ * @return length of the key. If it is larger than size, buf holds the first
+ * size bytes only.
+ */
+size_t semver_version_collation_key(const semver_version self, int flags,
+                                    unsigned char *buf, size_t size);
+
+/**
+ * semver_version_from_collation_key allocates a new semver_version decoded
+ * from a collation key. Build metadata is restored only if it was encoded.
+ * Must use semver_version_delete to free space.
+ * @param[in] buf key as returned by semver_version_collation_key
+ * @param[in] len length of the key
+ * @return pointer to allocated semver_version, NULL if the key is malformed
+ */
+semver_version semver_version_from_collation_key(const unsigned char *buf,
+                                                 size_t len);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,102 @@
+/*
+ * MIT License
+ *
+ * Copyright 2023 @aschmidt75
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __SEMVERARENA_H
+#define __SEMVERARENA_H
+
+#include "semver.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * semver_arena
+ *
+ * is a bump-pointer allocator for constructing many semver_version and
+ * semver_version_req objects that are released all at once. Use the *_in
+ * constructors of semver.h and semverreq.h to allocate from an arena.
+ * Objects allocated from an arena must not be deleted individually,
+ * semver_version_delete and semver_version_req_delete do nothing for them.
+ * An arena is not thread-safe.
+ */
+
+/** default size of a memory block of an arena */
+#define SEMVER_ARENA_DEFAULT_BLOCK_SIZE 65536
+
+/**
+ * semver_arena_new creates a new, empty arena. Memory is requested in blocks
+ * of block_size bytes, 0 selects SEMVER_ARENA_DEFAULT_BLOCK_SIZE. Must use
+ * semver_arena_delete to free memory after use.
+ * @param[in] block_size size of memory blocks, or 0
+ * @return pointer to allocated arena, 0 if out of memory
+ */
+semver_arena semver_arena_new(size_t block_size);
+
+/**
+ * semver_arena_new_with is semver_arena_new, requesting blocks from given
+ * allocator instead of the library's allocator, see semver_set_allocator.
+ * @param[in] allocator allocator for blocks, copied. NULL for the library's.
+ * @param[in] block_size size of memory blocks, or 0
+ * @return pointer to allocated arena, 0 if out of memory
+ */
+semver_arena semver_arena_new_with(const semver_allocator *allocator,
+                                   size_t block_size);
+
+/**
+ * semver_arena_delete frees all objects allocated from the arena, and the
+ * arena itself.
+ * @param[in] self arena to delete
+ */
+void semver_arena_delete(semver_arena self);
+
+/**
+ * semver_arena_reset frees all objects allocated from the arena at once.
+ * The arena keeps the block it currently allocates from, frees all others
+ * and can be used again.
+ * @param[in] self arena to reset
+ */
+void semver_arena_reset(semver_arena self);
+
+/**
+ * semver_arena_alloc allocates size bytes from the arena, aligned to
+ * SEMVER_STORAGE_ALIGN. Allocations larger than the block size get a block of
+ * their own.
+ * @param[in] self arena
+ * @param[in] size number of bytes
+ * @return pointer to memory, 0 if out of memory
+ */
+void *semver_arena_alloc(semver_arena self, size_t size);
+
+/**
+ * semver_arena_used returns the number of bytes handed out by the arena since
+ * it was created or reset.
+ * @param[in] self arena
+ */
+size_t semver_arena_used(const semver_arena self);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
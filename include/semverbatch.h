@@ -0,0 +1,117 @@
+/*
+ * MIT License
+ *
+ * Copyright 2023 @aschmidt75
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __SEMVERBATCH_H
+#define __SEMVERBATCH_H
+
+#include "semver.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * semver_version_batch
+ *
+ * holds many parsed versions in columns (struct-of-arrays) instead of one
+ * semver_version object each. Item i is described by major[i], minor[i],
+ * patch[i], the prerelease and build strings at pool + prerelease_off[i]
+ * and pool + build_off[i] (NUL-terminated), and err[i]. Absent prerelease
+ * or build parts have an offset of SEMVER_BATCH_NONE. Items that could not be
+ * parsed have err[i] != SEMVER_OK, zero version numbers and no strings.
+ * Columns are read-only for the caller.
+ */
+typedef struct {
+  /** number of items */
+  size_t n;
+  /** number of items with err[i] == SEMVER_OK */
+  size_t n_ok;
+
+  unsigned long *major;
+  unsigned long *minor;
+  unsigned long *patch;
+  size_t *prerelease_off;
+  size_t *build_off;
+  /** per-item SEMVER_OK or error code, see semver_version_codes */
+  int *err;
+
+  /** shared string pool for prerelease and build parts */
+  char *pool;
+  size_t pool_len;
+  size_t pool_cap;
+} semver_version_batch;
+
+/** offset of an absent prerelease or build part */
+#define SEMVER_BATCH_NONE ((size_t)-1)
+
+/**
+ * semver_version_batch_parse parses n version strings into columns of batch.
+ * Per-item errors are reported in batch->err and do not stop parsing.
+ * Must use semver_version_batch_destroy to free memory after use.
+ * @param[out] batch batch to initialize
+ * @param[in] strs array of n version strings
+ * @param[in] lens array of n string lengths, or NULL if strs are NUL-terminated
+ * @param[in] n number of strings
+ * @return SEMVER_OK, or SEMVER_ERROR_OUT_OF_MEMORY. The batch is empty then.
+ */
+int semver_version_batch_parse(semver_version_batch *batch,
+                               const char *const *strs, const size_t *lens,
+                               size_t n);
+
+/**
+ * semver_version_batch_destroy frees the columns of batch. The struct itself
+ * is not freed.
+ * @param[in] batch batch to destroy
+ */
+void semver_version_batch_destroy(semver_version_batch *batch);
+
+/**
+ * semver_version_batch_prerelease returns the prerelease part of item i,
+ * or NULL if absent or the item could not be parsed.
+ */
+const char *semver_version_batch_prerelease(const semver_version_batch *batch,
+                                            size_t i);
+
+/**
+ * semver_version_batch_build returns the build part of item i,
+ * or NULL if absent or the item could not be parsed.
+ */
+const char *semver_version_batch_build(const semver_version_batch *batch,
+                                       size_t i);
+
+/**
+ * semver_version_batch_init_version initializes a semver_version in
+ * caller-provided storage from item i, e.g. for comparisons.
+ * Must use semver_version_destroy to release it.
+ * @return pointer to initialized semver_version struct, 0 if item i could not
+ * be parsed or memory could not be allocated.
+ */
+semver_version
+semver_version_batch_init_version(const semver_version_batch *batch, size_t i,
+                                  semver_version_storage *mem);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
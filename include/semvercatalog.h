@@ -0,0 +1,123 @@
+/*
+ * MIT License
+ *
+ * Copyright 2023 @aschmidt75
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __SEMVERCATALOG_H
+#define __SEMVERCATALOG_H
+
+#include "semver.h"
+#include "semverreq.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * semver_catalog
+ *
+ * is an immutable, sorted set of versions, e.g. all releases of a package,
+ * for resolver queries such as "highest version matching a requirement".
+ * Queries binary-search the bounds of requirements, taking O(log n)
+ * comparisons instead of matching each version. Versions of equal
+ * precedence, e.g. differing in build metadata only, are all kept, in the
+ * order given. A catalog may be shared between threads.
+ */
+struct semver_catalog;
+typedef struct semver_catalog *semver_catalog;
+
+/**
+ * semver_catalog_new builds a catalog of n versions. The versions are
+ * copied, vs may be freed afterwards.
+ * Must use semver_catalog_delete to free memory after use.
+ * @param[in] vs array of n versions, in any order
+ * @param[in] n number of versions
+ * @return pointer to allocated catalog, 0 if out of memory
+ */
+semver_catalog semver_catalog_new(const semver_version *vs, size_t n);
+
+/**
+ * semver_catalog_delete frees the catalog and its versions.
+ * @param[in] self catalog to delete
+ */
+void semver_catalog_delete(semver_catalog self);
+
+/**
+ * semver_catalog_count returns the number of versions in the catalog.
+ */
+size_t semver_catalog_count(const semver_catalog self);
+
+/**
+ * semver_catalog_get returns the version at position i in precedence order.
+ * Versions returned by catalog functions are owned by the catalog, and must
+ * not be deleted or modified.
+ * @return version, 0 if i is out of range
+ */
+semver_version semver_catalog_get(const semver_catalog self, size_t i);
+
+/**
+ * semver_catalog_max_satisfying returns the highest version matching req,
+ * the last one given of equal precedence.
+ * @return version, 0 if none matches
+ */
+semver_version semver_catalog_max_satisfying(const semver_catalog self,
+                                             const semver_version_req req);
+
+/**
+ * semver_catalog_min_satisfying returns the lowest version matching req,
+ * the first one given of equal precedence.
+ * @return version, 0 if none matches
+ */
+semver_version semver_catalog_min_satisfying(const semver_catalog self,
+                                             const semver_version_req req);
+
+/**
+ * semver_catalog_floor returns the highest version not above v.
+ * @return version, 0 if all versions are above v
+ */
+semver_version semver_catalog_floor(const semver_catalog self,
+                                    const semver_version v);
+
+/**
+ * semver_catalog_ceiling returns the lowest version not below v.
+ * @return version, 0 if all versions are below v
+ */
+semver_version semver_catalog_ceiling(const semver_catalog self,
+                                      const semver_version v);
+
+/**
+ * semver_catalog_req_range returns the positions of the versions matching
+ * req: the ones at positions *begin <= i < *end, see semver_catalog_get.
+ * @param[in] self catalog
+ * @param[in] req requirement
+ * @param[out] begin position of the first matching version
+ * @param[out] end position behind the last matching version, >= *begin
+ * @return number of matching versions, *end - *begin
+ */
+size_t semver_catalog_req_range(const semver_catalog self,
+                                const semver_version_req req, size_t *begin,
+                                size_t *end);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
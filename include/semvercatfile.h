@@ -0,0 +1,148 @@
+/*
+ * MIT License
+ *
+ * Copyright 2023 @aschmidt75
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __SEMVERCATFILE_H
+#define __SEMVERCATFILE_H
+
+#include "semver.h"
+#include "semverreq.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * semver_catfile
+ *
+ * is a read-only catalog of versions in a file, mapped into memory with
+ * mmap. Versions are served from the mapped pages without parsing, so
+ * opening a catalog takes time independent of its size (apart from checks
+ * of its structure), and processes mapping the same file share its memory
+ * through the page cache.
+ *
+ * A catalog file, written by semver_catfile_write, holds:
+ * - a header: magic bytes "semvcat\n", format version
+ *   (SEMVER_CATFILE_VERSION), byte order mark, word size, number of
+ *   versions, and offsets and lengths of the sections below,
+ * - the records of the versions, sorted by precedence, 64-byte aligned:
+ *   the packed ordering key, the rank of its precedence, major, minor and
+ *   patch versions, the number of prerelease identifiers, and offsets and
+ *   lengths of prerelease and build strings,
+ * - a pool of NUL-terminated prerelease and build strings.
+ * Words are unsigned longs in the byte order of the writer. Files are only
+ * readable on platforms with the same word size and byte order.
+ */
+struct semver_catfile;
+typedef struct semver_catfile *semver_catfile;
+
+/** version of the file format written by semver_catfile_write */
+#define SEMVER_CATFILE_VERSION 1
+
+/**
+ * semver_catfile_write writes a catalog file of n versions to fd.
+ * @param[in] fd file descriptor to write to
+ * @param[in] vs array of n versions, in any order
+ * @param[in] n number of versions
+ * @return SEMVER_OK, SEMVER_ERROR_OUT_OF_MEMORY or SEMVER_ERROR_IO
+ */
+int semver_catfile_write(int fd, const semver_version *vs, size_t n);
+
+/**
+ * semver_catfile_open maps a catalog file into memory.
+ * Must use semver_catfile_close to unmap it after use.
+ * @param[in] path path of the catalog file
+ * @param[out] out opened catalog
+ * @return SEMVER_OK, SEMVER_ERROR_IO if the file cannot be opened or
+ * mapped, SEMVER_ERROR_STRUCTURE if it is not a valid catalog file (of
+ * this platform), or SEMVER_ERROR_OUT_OF_MEMORY
+ */
+int semver_catfile_open(const char *path, semver_catfile *out);
+
+/**
+ * semver_catfile_close unmaps the catalog. Strings returned by it become
+ * invalid.
+ * @param[in] self catalog to close
+ */
+void semver_catfile_close(semver_catfile self);
+
+/**
+ * semver_catfile_count returns the number of versions in the catalog.
+ */
+size_t semver_catfile_count(const semver_catfile self);
+
+/**
+ * semver_catfile_major, _minor and _patch return the version numbers of the
+ * version at position i, i < semver_catfile_count(self). Positions are in
+ * precedence order.
+ */
+unsigned long semver_catfile_major(const semver_catfile self, size_t i);
+unsigned long semver_catfile_minor(const semver_catfile self, size_t i);
+unsigned long semver_catfile_patch(const semver_catfile self, size_t i);
+
+/**
+ * semver_catfile_prerelease and semver_catfile_build return the prerelease
+ * and build strings of the version at position i, pointing into the mapped
+ * file.
+ * @return NUL-terminated string, 0 if the version has none
+ */
+const char *semver_catfile_prerelease(const semver_catfile self, size_t i);
+const char *semver_catfile_build(const semver_catfile self, size_t i);
+
+/**
+ * semver_catfile_cmp compares the versions at positions i and j by
+ * precedence, like semver_version_cmp, in constant time.
+ * @return <0, 0, >0 if version i is less than, equal to or greater than j
+ */
+int semver_catfile_cmp(const semver_catfile self, size_t i, size_t j);
+
+/**
+ * semver_catfile_get initializes the version at position i in
+ * caller-provided storage, without parsing. Must be released using
+ * semver_version_destroy.
+ * @return version, 0 if out of memory
+ */
+semver_version semver_catfile_get(const semver_catfile self, size_t i,
+                                  semver_version_storage *mem);
+
+/**
+ * semver_catfile_lower_bound returns the position of the first version not
+ * below v, semver_catfile_count(self) if there is none.
+ */
+size_t semver_catfile_lower_bound(const semver_catfile self,
+                                  const semver_version v);
+
+/**
+ * semver_catfile_req_range returns the positions of the versions matching
+ * req: the ones at positions *begin <= i < *end, see
+ * semver_version_req_range.
+ * @return number of matching versions, *end - *begin
+ */
+size_t semver_catfile_req_range(const semver_catfile self,
+                                const semver_version_req req, size_t *begin,
+                                size_t *end);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,121 @@
+/*
+ * MIT License
+ *
+ * Copyright 2023 @aschmidt75
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __SEMVERINTERN_H
+#define __SEMVERINTERN_H
+
+#include "semver.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * semver_intern
+ *
+ * is a table of distinct versions, each one identified by a dense integer
+ * ID (0, 1, 2, ...) assigned in order of insertion. Interning the same
+ * version again yields the same ID, so equal IDs mean identical versions,
+ * including build metadata. Each version is stored once, as a canonical
+ * semver_version owned by the table. Looking up a string that has been
+ * interned before is a hash lookup, without parsing. IDs and canonical
+ * versions stay valid until the table is deleted. A table is not
+ * thread-safe.
+ */
+struct semver_intern;
+typedef struct semver_intern *semver_intern;
+
+/** largest number of versions a table can hold */
+#define SEMVER_INTERN_MAX 0xffffffffUL
+
+/**
+ * semver_intern_new creates a new, empty table.
+ * Must use semver_intern_delete to free memory after use.
+ * @return pointer to allocated table, 0 if out of memory
+ */
+semver_intern semver_intern_new(void);
+
+/**
+ * semver_intern_delete frees the table and all of its canonical versions.
+ * @param[in] self table to delete
+ */
+void semver_intern_delete(semver_intern self);
+
+/**
+ * semver_intern_strn interns the version given by the first len bytes of
+ * buf, see semver_version_from_strn.
+ * @param[in] self table
+ * @param[in] buf version input
+ * @param[in] len number of bytes
+ * @param[out] id ID of the version
+ * @return SEMVER_OK, a parsing error code, or SEMVER_ERROR_OUT_OF_MEMORY
+ */
+int semver_intern_strn(semver_intern self, const char *buf, size_t len,
+                       unsigned long *id);
+
+/**
+ * semver_intern_string interns the version given by a string.
+ * @return SEMVER_OK, a parsing error code, or SEMVER_ERROR_OUT_OF_MEMORY
+ */
+int semver_intern_string(semver_intern self, const char *s,
+                         unsigned long *id);
+
+/**
+ * semver_intern_version interns a parsed version. The table keeps a copy.
+ * @return SEMVER_OK, or SEMVER_ERROR_OUT_OF_MEMORY
+ */
+int semver_intern_version(semver_intern self, const semver_version v,
+                          unsigned long *id);
+
+/**
+ * semver_intern_find looks up a version string without interning it.
+ * @return 1 and its ID in *id if interned before, 0 otherwise
+ */
+int semver_intern_find(const semver_intern self, const char *buf, size_t len,
+                       unsigned long *id);
+
+/**
+ * semver_intern_get returns the canonical version of an ID. It is owned by
+ * the table, and must not be deleted or modified.
+ * @return canonical version, 0 if id is unknown
+ */
+semver_version semver_intern_get(const semver_intern self, unsigned long id);
+
+/**
+ * semver_intern_str returns the canonical string of an ID, owned by the
+ * table.
+ * @return NUL-terminated version string, 0 if id is unknown
+ */
+const char *semver_intern_str(const semver_intern self, unsigned long id);
+
+/**
+ * semver_intern_count returns the number of versions in the table, which is
+ * also the next ID to be assigned.
+ */
+size_t semver_intern_count(const semver_intern self);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,64 @@
+/*
+ * MIT License
+ *
+ * Copyright 2023 @aschmidt75
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __SEMVERMATRIX_H
+#define __SEMVERMATRIX_H
+
+#include "semver.h"
+#include "semverreq.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * size in bytes of the match matrix of m requirements and n versions, see
+ * semver_version_req_match_matrix
+ */
+#define SEMVER_MATRIX_SIZE(m, n) ((m) * SEMVERREQ_BITMAP_SIZE(n))
+
+/**
+ * semver_version_req_match_matrix matches each of m requirements against
+ * each of n versions. Row r of the matrix, SEMVERREQ_BITMAP_SIZE(n) bytes
+ * starting at bitmap + r * SEMVERREQ_BITMAP_SIZE(n), is the bitmap of the
+ * versions matching reqs[r], as written by semver_version_req_matches_many.
+ * Requirements and versions are encoded into packed bounds and keys once,
+ * and matched tile by tile, using vector instructions where available.
+ * @param[in] reqs array of m requirements
+ * @param[in] m number of requirements
+ * @param[in] vs array of n versions
+ * @param[in] n number of versions
+ * @param[out] bitmap SEMVER_MATRIX_SIZE(m, n) bytes
+ * @param[out] counts if given, array of m numbers of versions matching each
+ * requirement
+ * @return SEMVER_OK, or SEMVER_ERROR_OUT_OF_MEMORY
+ */
+int semver_version_req_match_matrix(const semver_version_req *reqs, size_t m,
+                                    const semver_version *vs, size_t n,
+                                    unsigned char *bitmap, size_t *counts);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
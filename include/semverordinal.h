@@ -0,0 +1,112 @@
+/*
+ * MIT License
+ *
+ * Copyright 2023 @aschmidt75
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __SEMVERORDINAL_H
+#define __SEMVERORDINAL_H
+
+#include "semver.h"
+#include "semverreq.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * semver_ordinal
+ *
+ * maps the versions of a fixed set, e.g. all releases of a package, to their
+ * ranks in precedence order: 0 for the lowest version, 1 for the next
+ * higher one, and so on. Versions of equal precedence, e.g. differing in
+ * build metadata only, share a rank. Once built, comparing versions of the
+ * set is comparing their ranks, and a requirement becomes a range of ranks.
+ * An ordinal map is immutable, and may be shared between threads.
+ */
+struct semver_ordinal;
+typedef struct semver_ordinal *semver_ordinal;
+
+/**
+ * semver_ordinal_new builds an ordinal map of n versions. The versions are
+ * copied, vs may be freed afterwards.
+ * Must use semver_ordinal_delete to free memory after use.
+ * @param[in] vs array of n versions, may contain duplicates
+ * @param[in] n number of versions
+ * @return pointer to allocated map, 0 if out of memory
+ */
+semver_ordinal semver_ordinal_new(const semver_version *vs, size_t n);
+
+/**
+ * semver_ordinal_delete frees the map.
+ * @param[in] self map to delete
+ */
+void semver_ordinal_delete(semver_ordinal self);
+
+/**
+ * semver_ordinal_count returns the number of ranks, i.e. distinct versions.
+ */
+size_t semver_ordinal_count(const semver_ordinal self);
+
+/**
+ * semver_ordinal_rank looks up the rank of a version, in constant time on
+ * average.
+ * @param[in] self map
+ * @param[in] v version to look up
+ * @param[out] rank rank of v
+ * @return 1 if v is in the set, 0 otherwise
+ */
+int semver_ordinal_rank(const semver_ordinal self, const semver_version v,
+                        size_t *rank);
+
+/**
+ * semver_ordinal_lower_bound returns the number of ranks below v, i.e. the
+ * rank of v if v is in the set, or the rank of the next higher version
+ * otherwise. Takes logarithmic time.
+ */
+size_t semver_ordinal_lower_bound(const semver_ordinal self,
+                                  const semver_version v);
+
+/**
+ * semver_ordinal_get returns the version of a rank. It is owned by the map,
+ * and must not be deleted or modified.
+ * @return version, 0 if rank is out of range
+ */
+semver_version semver_ordinal_get(const semver_ordinal self, size_t rank);
+
+/**
+ * semver_ordinal_req_range converts a requirement to the ranks it admits: a
+ * version of the set matches req if and only if its rank r satisfies
+ * *begin <= r < *end.
+ * @param[in] self map
+ * @param[in] req requirement
+ * @param[out] begin first admitted rank
+ * @param[out] end rank behind the last admitted one, >= *begin
+ * @return number of admitted ranks, *end - *begin
+ */
+size_t semver_ordinal_req_range(const semver_ordinal self,
+                                const semver_version_req req, size_t *begin,
+                                size_t *end);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
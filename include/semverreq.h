@@ -59,7 +59,9 @@ typedef enum {
   /** a semver part is invalid */
   SEMVERREQ_INVALID_SEMVER = 22,
   /** a comparator is invalid */
-  SEMVERREQ_INVALID_COMPARATOR = 23
+  SEMVERREQ_INVALID_COMPARATOR = 23,
+  /** memory could not be allocated */
+  SEMVERREQ_OUT_OF_MEMORY = 24
 
 } semver_version_req_codes;
 
@@ -76,6 +78,24 @@ typedef struct {
 /* maximum length of a parseable semver_req string */
 #define SEMVERREQ_MAXLEN 512
 
+/**
+ * size in bytes of caller-provided storage for a semver_version_req, see
+ * semver_version_req_init_from_string. Must be aligned to SEMVER_STORAGE_ALIGN.
+ */
+#define SEMVERREQ_STORAGE_SIZE (2 * SEMVER_VERSION_STORAGE_SIZE + 32)
+
+/**
+ * semver_version_req_storage is caller-provided memory for a
+ * semver_version_req. Contents are opaque. Like semver_version_storage, an
+ * initialized storage may be moved with memcpy.
+ */
+typedef union {
+  unsigned char bytes[SEMVERREQ_STORAGE_SIZE];
+  unsigned long align_ul;
+  void *align_p;
+  double align_d;
+} semver_version_req_storage;
+
 /**
  * semver_version_req_from creates a new semver version requirement from a given
  * lower and upper bound. lower_bound or upper_bound may be 0 to indicate
@@ -110,10 +130,73 @@ semver_version_req semver_version_req_from_string(const char *str);
 semver_version_req_wrapped semver_version_req_from_string_wrapped(const char *str);
 
 /**
- * Deallocates memory of a semver_version_req
+ * semver_version_req_from_strn(_wrapped) parse a requirement from the first
+ * len bytes of buf, which need not be NUL-terminated. Input is not copied.
+ */
+semver_version_req semver_version_req_from_strn(const char *buf, size_t len);
+semver_version_req_wrapped semver_version_req_from_strn_wrapped(const char *buf,
+                                                                size_t len);
+
+/**
+ * semver_version_req_*_in are the constructors from above, allocating from
+ * an arena instead of the heap. Returned requirements are released with the
+ * arena, see semverarena.h.
+ */
+semver_version_req semver_version_req_from_in(semver_arena arena,
+                                              semver_version lower_bound,
+                                              int lower_including,
+                                              semver_version upper_bound,
+                                              int upper_including);
+semver_version_req semver_version_req_from_string_in(semver_arena arena,
+                                                     const char *str);
+semver_version_req_wrapped
+semver_version_req_from_string_wrapped_in(semver_arena arena, const char *str);
+semver_version_req semver_version_req_from_strn_in(semver_arena arena,
+                                                   const char *buf, size_t len);
+semver_version_req_wrapped
+semver_version_req_from_strn_wrapped_in(semver_arena arena, const char *buf,
+                                        size_t len);
+
+/**
+ * same as semver_version_req_from_string, but parses into caller-provided
+ * storage. Does not allocate memory unless a bound's prerelease and build
+ * parts exceed their storage. Must be released using
+ * semver_version_req_destroy.
+ */
+semver_version_req
+semver_version_req_init_from_string(semver_version_req_storage *mem,
+                                    const char *str);
+
+/**
+ * same as above, but as wrapped version with error code handling
+ */
+semver_version_req_wrapped
+semver_version_req_init_from_string_wrapped(semver_version_req_storage *mem,
+                                            const char *str);
+
+/**
+ * length-delimited variants of the two above, see
+ * semver_version_req_from_strn.
+ */
+semver_version_req
+semver_version_req_init_from_strn(semver_version_req_storage *mem,
+                                  const char *buf, size_t len);
+semver_version_req_wrapped
+semver_version_req_init_from_strn_wrapped(semver_version_req_storage *mem,
+                                          const char *buf, size_t len);
+
+/**
+ * Deallocates memory of a semver_version_req. For requirements in
+ * caller-provided storage, this is the same as semver_version_req_destroy.
  */
 void semver_version_req_delete(semver_version_req self);
 
+/**
+ * Releases memory held by a semver_version_req in caller-provided storage.
+ * The storage itself is not freed.
+ */
+void semver_version_req_destroy(semver_version_req self);
+
 #ifdef __HAS_SNPRINTF__
 /**
  * Formats the semver requirement into a string
@@ -133,6 +216,91 @@ int semver_version_req_sprint(semver_version_req self, char *buf);
  */
 int semver_version_req_matches(semver_version_req self, semver_version v);
 
+/**
+ * semver_version_req_compiled is the compiled form of a requirement: the
+ * packed ordering keys of its bounds (see semver_version_key_of) and flags,
+ * in one flat structure without pointers that fits a cache line. Contents
+ * are opaque. It may be copied freely, and stays valid as long as the
+ * requirement it was compiled from (which is consulted in rare cases, see
+ * below).
+ */
+typedef struct {
+  semver_version_key lower;
+  semver_version_key upper;
+  unsigned int flags;
+} semver_version_req_compiled;
+
+/**
+ * result of semver_version_req_compiled_match_key if keys are not enough to
+ * decide a match
+ */
+#define SEMVERREQ_UNDECIDED (-1)
+
+/**
+ * semver_version_req_compile compiles a requirement.
+ * @param[in] self requirement
+ * @param[out] out compiled requirement
+ */
+void semver_version_req_compile(const semver_version_req self,
+                                semver_version_req_compiled *out);
+
+/**
+ * semver_version_req_compiled_match_key checks if a version, given by its
+ * ordering key, matches a compiled requirement, by integer comparisons only.
+ * This decides unless the version's key equals the key of a bound that has
+ * a prerelease, or minor or patch values too large for the key.
+ * @param[in] c compiled requirement
+ * @param[in] k ordering key of the version
+ * @return 1 if it matches, 0 if not, SEMVERREQ_UNDECIDED otherwise
+ */
+int semver_version_req_compiled_match_key(const semver_version_req_compiled *c,
+                                          const semver_version_key *k);
+
+/**
+ * semver_version_req_compiled_matches is semver_version_req_matches for a
+ * compiled requirement. Falls back to the requirement it was compiled from,
+ * self, if undecided by the keys.
+ * @returns 1 if it matches, 0 otherwise
+ */
+int semver_version_req_compiled_matches(const semver_version_req_compiled *c,
+                                        const semver_version_req self,
+                                        const semver_version v);
+
+/** number of bytes of a bitmap of n bits, see semver_version_req_matches_many */
+#define SEMVERREQ_BITMAP_SIZE(n) (((n) + 7) / 8)
+
+/**
+ * semver_version_req_matches_many checks which versions of an array match
+ * a requirement. Bit i of the bitmap, i.e. bit i % 8 of byte i / 8, is set
+ * if vs[i] matches, and cleared otherwise; unused bits of the last byte are
+ * cleared.
+ * @param[in] self requirement
+ * @param[in] vs array of n versions
+ * @param[in] n number of versions
+ * @param[out] bitmap SEMVERREQ_BITMAP_SIZE(n) bytes, or NULL to count only
+ * @return number of matching versions
+ */
+size_t semver_version_req_matches_many(const semver_version_req self,
+                                       const semver_version *vs, size_t n,
+                                       unsigned char *bitmap);
+
+/**
+ * semver_version_req_matches_keys is semver_version_req_matches_many on
+ * precomputed ordering keys, keys[i] = semver_version_key_of(vs[i]). Most
+ * versions are decided by their keys alone, vs is read only for the others,
+ * see semver_version_req_compiled_match_key.
+ * @param[in] self requirement
+ * @param[in] keys array of n ordering keys
+ * @param[in] vs array of the n versions of the keys
+ * @param[in] n number of versions
+ * @param[out] bitmap SEMVERREQ_BITMAP_SIZE(n) bytes, or NULL to count only
+ * @return number of matching versions
+ */
+size_t semver_version_req_matches_keys(const semver_version_req self,
+                                       const semver_version_key *keys,
+                                       const semver_version *vs, size_t n,
+                                       unsigned char *bitmap);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,106 @@
+/*
+ * MIT License
+ *
+ * Copyright 2023 @aschmidt75
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __SEMVERREQINDEX_H
+#define __SEMVERREQINDEX_H
+
+#include "semver.h"
+#include "semverreq.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * semver_req_index
+ *
+ * is an index of requirements that answers "which requirements does
+ * version v match?" without testing each of them. It is a centered
+ * interval tree over the requirements' bounds: a query takes O(log n + k)
+ * comparisons for n requirements of which k match. Requirements may be
+ * inserted and removed at any time, in O(log n) amortized time plus the
+ * number of requirements sharing a tree node.
+ *
+ * The index refers to the requirements, it does not copy them: they must
+ * stay valid, and unchanged, while they are indexed. An index is not
+ * thread-safe, but concurrent queries without modifications are.
+ */
+struct semver_req_index;
+typedef struct semver_req_index *semver_req_index;
+
+/**
+ * semver_req_index_new creates a new, empty index.
+ * Must use semver_req_index_delete to free memory after use.
+ * @return pointer to allocated index, 0 if out of memory
+ */
+semver_req_index semver_req_index_new(void);
+
+/**
+ * semver_req_index_delete frees the index. Indexed requirements are not
+ * freed.
+ * @param[in] self index to delete
+ */
+void semver_req_index_delete(semver_req_index self);
+
+/**
+ * semver_req_index_insert adds a requirement to the index. A requirement
+ * may be added more than once, and is reported once per insertion then.
+ * @param[in] self index
+ * @param[in] req requirement
+ * @return SEMVER_OK, or SEMVER_ERROR_OUT_OF_MEMORY
+ */
+int semver_req_index_insert(semver_req_index self, semver_version_req req);
+
+/**
+ * semver_req_index_remove removes a requirement from the index, one
+ * insertion of it if inserted more than once.
+ * @param[in] self index
+ * @param[in] req requirement, as given to semver_req_index_insert
+ * @return 1 if removed, 0 if req is not in the index
+ */
+int semver_req_index_remove(semver_req_index self, semver_version_req req);
+
+/**
+ * semver_req_index_count returns the number of indexed requirements.
+ */
+size_t semver_req_index_count(const semver_req_index self);
+
+/**
+ * semver_req_index_stab finds the requirements that version v matches, see
+ * semver_version_req_matches, in no particular order.
+ * @param[in] self index
+ * @param[in] v version
+ * @param[out] out array receiving the first cap matching requirements, may
+ * be NULL if cap is 0
+ * @param[in] cap size of out
+ * @return number of matching requirements, which may exceed cap
+ */
+size_t semver_req_index_stab(const semver_req_index self,
+                             const semver_version v, semver_version_req *out,
+                             size_t cap);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,172 @@
+/*
+ * MIT License
+ *
+ * Copyright 2023 @aschmidt75
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __SEMVERSORT_H
+#define __SEMVERSORT_H
+
+#include "semver.h"
+#include "semverreq.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * flag for semver_version_sort_flags and semver_version_sort_strings: move
+ * versions of equal precedence behind the first one of them to the end of
+ * the array, see below.
+ */
+#define SEMVER_SORT_UNIQUE 1
+
+/**
+ * semver_version_sort sorts an array of versions by precedence, ascending.
+ * The sort is stable: versions of equal precedence, e.g. differing in build
+ * metadata only, keep their relative order.
+ * @param[in,out] arr array of n versions, != NULL
+ * @param[in] n number of versions
+ * @return SEMVER_OK, or SEMVER_ERROR_OUT_OF_MEMORY. arr is unchanged then.
+ */
+int semver_version_sort(semver_version *arr, size_t n);
+
+/**
+ * semver_version_sort_flags is semver_version_sort with flags. With
+ * SEMVER_SORT_UNIQUE, arr is split into the sorted, distinct versions
+ * followed by the versions dropped as duplicates, in sorted order. The
+ * caller still owns all of them.
+ * @param[in,out] arr array of n versions, != NULL
+ * @param[in] n number of versions
+ * @param[in] flags 0 or SEMVER_SORT_UNIQUE
+ * @param[out] n_out if given, number of sorted (distinct) versions
+ * @return SEMVER_OK, or SEMVER_ERROR_OUT_OF_MEMORY. arr is unchanged then.
+ */
+int semver_version_sort_flags(semver_version *arr, size_t n, int flags,
+                              size_t *n_out);
+
+/**
+ * semver_version_sort_parallel is semver_version_sort_flags on up to
+ * n_threads threads. The result is identical to the one of the serial sort.
+ * Small arrays, and builds without thread support (SEMVER_HAVE_PTHREAD), are
+ * sorted on the calling thread.
+ * @param[in,out] arr array of n versions, != NULL
+ * @param[in] n number of versions
+ * @param[in] flags 0 or SEMVER_SORT_UNIQUE
+ * @param[out] n_out if given, number of sorted (distinct) versions
+ * @param[in] n_threads maximum number of threads, including the calling one
+ * @return SEMVER_OK, or SEMVER_ERROR_OUT_OF_MEMORY. arr is unchanged then.
+ */
+int semver_version_sort_parallel(semver_version *arr, size_t n, int flags,
+                                 size_t *n_out, unsigned int n_threads);
+
+/**
+ * semver_version_sort_strings sorts an array of version strings by the
+ * precedence of the versions they contain, like semver_version_sort_flags.
+ * Strings that cannot be parsed are moved to the end of the array, keeping
+ * their order. Only the pointers are reordered.
+ * @param[in,out] strs array of n version strings, != NULL
+ * @param[in] n number of strings
+ * @param[in] flags 0 or SEMVER_SORT_UNIQUE
+ * @param[out] n_out if given, number of valid (distinct) version strings at
+ * the beginning of strs
+ * @return SEMVER_OK, or SEMVER_ERROR_OUT_OF_MEMORY. strs is unchanged then.
+ */
+int semver_version_sort_strings(const char **strs, size_t n, int flags,
+                                size_t *n_out);
+
+/**
+ * semver_version_lower_bound returns the position of the first version not
+ * below v in an array sorted by precedence, e.g. by semver_version_sort; n if
+ * there is none. Takes O(log n) comparisons.
+ */
+size_t semver_version_lower_bound(const semver_version *arr, size_t n,
+                                  const semver_version v);
+
+/**
+ * semver_version_upper_bound returns the position of the first version above
+ * v in an array sorted by precedence; n if there is none.
+ */
+size_t semver_version_upper_bound(const semver_version *arr, size_t n,
+                                  const semver_version v);
+
+/**
+ * semver_version_req_range finds the versions matching a requirement in an
+ * array sorted by precedence. As requirements are ranges of versions, they
+ * match the contiguous positions *begin <= i < *end, found by two binary
+ * searches.
+ * @param[in] req requirement
+ * @param[in] arr array of n versions, sorted by precedence
+ * @param[in] n number of versions
+ * @param[out] begin position of the first matching version
+ * @param[out] end position behind the last matching version, >= *begin
+ * @return number of matching versions, *end - *begin
+ */
+size_t semver_version_req_range(const semver_version_req req,
+                                const semver_version *arr, size_t n,
+                                size_t *begin, size_t *end);
+
+/**
+ * semver_version_req_range_keyed is semver_version_req_range with the
+ * ordering keys of the versions, keys[i] = semver_version_key_of(arr[i]),
+ * which replace most comparisons of versions by comparisons of integers.
+ */
+size_t semver_version_req_range_keyed(const semver_version_req req,
+                                      const semver_version *arr,
+                                      const semver_version_key *keys, size_t n,
+                                      size_t *begin, size_t *end);
+
+/** default memory budget of semver_version_sort_fd, in bytes */
+#define SEMVER_SORT_DEFAULT_BUDGET (64 * 1024 * 1024)
+
+/** options of semver_version_sort_fd */
+typedef struct {
+  /** approximate upper bound of memory to use, 0 for the default */
+  size_t mem_budget;
+  /** directory of temporary files, NULL for TMPDIR or /tmp */
+  const char *tmp_dir;
+  /** 0 or SEMVER_SORT_UNIQUE */
+  int flags;
+  /** maximum number of threads for sorting runs, 0 or 1 for one */
+  unsigned int n_threads;
+} semver_sort_fd_options;
+
+/**
+ * semver_version_sort_fd sorts newline-delimited versions read from in_fd
+ * until end of file, and writes them to out_fd in precedence order, one per
+ * line. Inputs larger than the memory budget are sorted in runs that are
+ * spilled to a temporary file, and merged afterwards. At most two temporary
+ * files are open at a time, however large the input is; they are unlinked
+ * right after creation. The sort is stable. Empty lines, and lines
+ * that cannot be parsed, are dropped; a trailing '\r' is ignored.
+ * @param[in] in_fd file descriptor to read from
+ * @param[in] out_fd file descriptor to write to
+ * @param[in] opts options, or NULL for defaults
+ * @param[out] n_out if given, number of lines written
+ * @return SEMVER_OK, SEMVER_ERROR_OUT_OF_MEMORY or SEMVER_ERROR_IO
+ */
+int semver_version_sort_fd(int in_fd, int out_fd,
+                           const semver_sort_fd_options *opts, size_t *n_out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -22,16 +22,74 @@
  * SOFTWARE.
  */
 
-#include <assert.h>
+#include <limits.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
 
 #include "semver.h"
+#include "semverarena.h"
+#include "semver_impl.h"
+
+void *semver_default_malloc(void *user, size_t size) {
+  return malloc(size);
+}
+
+void *semver_default_realloc(void *user, void *ptr, size_t size) {
+  return realloc(ptr, size);
+}
+
+void semver_default_free(void *user, void *ptr) {
+  free(ptr);
+}
+
+/* allocator in use, see semver_set_allocator */
+semver_allocator semver_allocator_current = {
+    semver_default_malloc, semver_default_realloc, semver_default_free, 0};
+
+void semver_set_allocator(const semver_allocator *allocator) {
+  if (allocator == NULL) {
+    semver_allocator_current.malloc_fn = semver_default_malloc;
+    semver_allocator_current.realloc_fn = semver_default_realloc;
+    semver_allocator_current.free_fn = semver_default_free;
+    semver_allocator_current.user = 0;
+    return;
+  }
+  semver_allocator_current = *allocator;
+}
+
+void semver_get_allocator(semver_allocator *allocator) {
+  if (allocator) {
+    *allocator = semver_allocator_current;
+  }
+}
+
+void *semver_malloc(size_t size) {
+  return semver_allocator_current.malloc_fn(semver_allocator_current.user,
+                                            size);
+}
+
+void *semver_realloc(void *ptr, size_t size) {
+  return semver_allocator_current.realloc_fn(semver_allocator_current.user,
+                                             ptr, size);
+}
+
+void semver_free(void *ptr) {
+  if (ptr) {
+    semver_allocator_current.free_fn(semver_allocator_current.user, ptr);
+  }
+}
+
+void *semver_alloc_in(semver_arena arena, size_t size) {
+  if (arena) {
+    return semver_arena_alloc(arena, size);
+  }
+  return semver_malloc(size);
+}
 
 char *semver_strdup(const char *str) {
   size_t n = strlen(str)+1;
-  char *d = malloc(n);
+  char *d = semver_malloc(n);
   if(d) {
     strcpy(d,str);
   }
@@ -40,167 +98,466 @@ char *semver_strdup(const char *str) {
 
 int semver_cmp(const char *_a, const char *_b, int *res) {
   semver_version a,b;
+  semver_version_storage mem_a, mem_b;
   if (!res) {
    return 1;
   }
 
-  a = semver_version_from_string(_a);
-  b = semver_version_from_string(_b);
+  a = semver_version_init_from_string(&mem_a, _a);
   if(!a) {
     return 2;
   }
+  b = semver_version_init_from_string(&mem_b, _b);
   if(!b) {
-    semver_version_delete(a);
+    semver_version_destroy(a);
     return 3;
   }
 
   *res = semver_version_cmp(a, b);
 
-  semver_version_delete(a);
-  semver_version_delete(b);
+  semver_version_destroy(a);
+  semver_version_destroy(b);
 
   return 0;
 }
 
 
-#define SEMVER_NEW(obj, type)                                                  \
-  do {                                                                         \
-    obj = malloc(sizeof(type));                                                \
-    if (!obj) {                                                                \
-      printf("Malloc Error: %s\n", __func__);                                  \
-      assert(0);                                                               \
-    }                                                                          \
-  } while (0)
-
 /**
- * semver_version_impl
- *
- * implements a semantic versioning (semver) record according to semver 2.0.0
- * @see https://semver.org/spec/v2.0.0.html
+ * semver_version_prerelease_str returns the NUL-terminated prerelease string
+ * of a version, or NULL.
  */
-typedef struct {
+const char *semver_version_prerelease_str(const semver_version_impl *self) {
+  if (!(self->flags & SEMVER_HAS_PRERELEASE)) {
+    return NULL;
+  }
+  return SEMVER_EXT(self) + self->n_idents * sizeof(semver_version_ident);
+}
 
-  /* Major version number */
-  unsigned long major;
+/**
+ * semver_version_build_str returns the NUL-terminated build string of a
+ * version, or NULL.
+ */
+const char *semver_version_build_str(const semver_version_impl *self) {
+  const char *p;
+  if (!(self->flags & SEMVER_HAS_BUILD)) {
+    return NULL;
+  }
+  p = SEMVER_EXT(self) + self->n_idents * sizeof(semver_version_ident);
+  if (self->flags & SEMVER_HAS_PRERELEASE) {
+    p += self->prerelease_len + 1;
+  }
+  return p;
+}
 
-  /* Minor version number */
-  unsigned long minor;
+/**
+ * semver_version_tokenize splits a prerelease string of length n into its
+ * identifiers and decodes numeric ones. Writes to idents if not NULL.
+ * Returns the number of identifiers, 0 for an empty string.
+ */
+size_t semver_version_tokenize(const char *s, size_t n,
+                               semver_version_ident *idents) {
+  size_t i = 0;
+  size_t k = 0;
+  const char *p = s;
+  const char *end = s + n;
+  const char *q;
+  unsigned int v;
+  int kind;
 
-  /* Patch number */
-  unsigned long patch;
+  if (n == 0) {
+    return 0;
+  }
+  do {
+    v = 0;
+    kind = SEMVER_IDENT_NUMERIC;
+    for (q = p; q < end && *q != '.'; q++) {
+      if (*q < '0' || *q > '9') {
+        kind = SEMVER_IDENT_ALNUM;
+      } else if (kind == SEMVER_IDENT_NUMERIC) {
+        if (v > (UINT_MAX - (unsigned int)(*q - '0')) / 10) {
+          kind = SEMVER_IDENT_BIGNUM;
+        } else {
+          v = v * 10 + (unsigned int)(*q - '0');
+        }
+      }
+    }
+    if (q == p) {
+      /* empty identifier, e.g. "alpha..1" */
+      kind = SEMVER_IDENT_ALNUM;
+    }
+    if (idents) {
+      idents[k].num = v;
+      idents[k].len = (unsigned int)(q - p);
+      idents[k].kind = kind;
+    }
+    k++;
+    i = (size_t)(q - s);
+    p = q + 1;
+  } while (i < n);
 
-  /* Prerelease string (optional) */
-  char *prerelease;
+  return k;
+}
 
-  /* Build string (optional) */
-  char *build;
+/**
+ * semver_version_view_ext_size returns the number of bytes of trailing
+ * storage needed to hold the view's prerelease and build parts.
+ */
+size_t semver_version_view_ext_size(const semver_version_view *v) {
+  size_t n = v->n_idents * sizeof(semver_version_ident);
+  if (v->prerelease) {
+    n += v->prerelease_len + 1;
+  }
+  if (v->build) {
+    n += v->build_len + 1;
+  }
+  return n;
+}
 
-} semver_version_impl;
+/**
+ * semver_version_view_fill sets all fields of self from a view and writes
+ * identifiers and strings into trailing storage ext. ext must be large enough,
+ * see semver_version_view_ext_size.
+ */
+void semver_version_view_fill(semver_version_impl *self,
+                              const semver_version_view *v, char *ext) {
+  char *p = ext + v->n_idents * sizeof(semver_version_ident);
+
+  self->major = v->major;
+  self->minor = v->minor;
+  self->patch = v->patch;
+  self->n_idents = 0;
+  self->prerelease_len = 0;
+  self->build_len = 0;
+  self->flags &= SEMVER_STORAGE_MASK;
+
+  if (v->prerelease) {
+    self->n_idents = (unsigned int)semver_version_tokenize(
+        v->prerelease, v->prerelease_len, (semver_version_ident *)ext);
+    self->prerelease_len = (unsigned int)v->prerelease_len;
+    self->flags |= SEMVER_HAS_PRERELEASE;
+    memcpy(p, v->prerelease, v->prerelease_len);
+    p[v->prerelease_len] = 0;
+    p += v->prerelease_len + 1;
+  }
+  if (v->build) {
+    self->build_len = (unsigned int)v->build_len;
+    self->flags |= SEMVER_HAS_BUILD;
+    memcpy(p, v->build, v->build_len);
+    p[v->build_len] = 0;
+  }
+}
 
 /**
- * semver_version_from_string parses a given string into the semver version
- * record. Returns SEMVER_OK for correctly processed semver strings, or an error
- * code. May allocated memory for prerelease and build strings, use
- * semver_version_delete. Do not call multiple times on existing parsed
- * structures, may leak memory.
+ * semver_version_view_of returns a view of an existing version
  */
-int semver_version_from_string_impl(semver_version self, const char *s);
+void semver_version_view_of(const semver_version_impl *self,
+                            semver_version_view *v) {
+  v->major = self->major;
+  v->minor = self->minor;
+  v->patch = self->patch;
+  v->prerelease = semver_version_prerelease_str(self);
+  v->prerelease_len = self->prerelease_len;
+  v->build = semver_version_build_str(self);
+  v->build_len = self->build_len;
+  v->n_idents = self->n_idents;
+}
+
+semver_version semver_version_from_view_in(semver_arena arena,
+                                           const semver_version_view *v) {
+  semver_version_impl *res;
+  size_t n = semver_version_view_ext_size(v);
+
+  res = semver_alloc_in(arena, sizeof(semver_version_impl) + n);
+  if (!res) {
+    return 0;
+  }
+  res->spill = 0;
+  res->capacity = (unsigned int)n;
+  res->flags = arena ? SEMVER_STORAGE_ARENA : 0;
+  semver_version_view_fill(res, v, (char *)(res + 1));
+
+  return (semver_version)res;
+}
+
+semver_version semver_version_init_view_in(semver_arena arena,
+                                           semver_version_storage *mem,
+                                           const semver_version_view *v) {
+  semver_version_impl *res = (semver_version_impl *)mem;
+  size_t n = semver_version_view_ext_size(v);
+
+  res->spill = 0;
+  res->capacity = SEMVER_VERSION_STORAGE_SIZE - sizeof(semver_version_impl);
+  res->flags = SEMVER_STORAGE_CALLER | (arena ? SEMVER_STORAGE_ARENA : 0);
+  if (n > res->capacity) {
+    res->spill = semver_alloc_in(arena, n);
+    if (!res->spill) {
+      return 0;
+    }
+  }
+  semver_version_view_fill(res, v, SEMVER_EXT(res));
+
+  return (semver_version)res;
+}
 
 semver_version semver_version_new(void) {
   semver_version_impl *res;
 
-  SEMVER_NEW(res, semver_version_impl);
+  res = semver_malloc(sizeof(semver_version_impl));
+  if (!res) {
+    return 0;
+  }
   res->major = 0;
   res->minor = 0;
   res->patch = 0;
-  res->prerelease = 0;
-  res->build = 0;
+  res->spill = 0;
+  res->capacity = 0;
+  res->n_idents = 0;
+  res->prerelease_len = 0;
+  res->build_len = 0;
+  res->flags = 0;
 
   return (semver_version )res;
 }
 
+/**
+ * semver_version_view_from sets up a view from given arguments, see
+ * semver_version_from. Empty strings are treated as absent.
+ */
+void semver_version_view_from(semver_version_view *v, unsigned long major,
+                              unsigned long minor, unsigned long patch,
+                              const char *prerelease, const char *build) {
+  v->major = major;
+  v->minor = minor;
+  v->patch = patch;
+  v->prerelease = 0;
+  v->prerelease_len = 0;
+  v->n_idents = 0;
+  v->build = 0;
+  v->build_len = 0;
+  if (prerelease != NULL && strlen(prerelease) > 0) {
+    v->prerelease = prerelease;
+    v->prerelease_len = strlen(prerelease);
+    v->n_idents = semver_version_tokenize(prerelease, v->prerelease_len, NULL);
+  }
+  if (build != NULL && strlen(build) > 0) {
+    v->build = build;
+    v->build_len = strlen(build);
+  }
+}
+
+semver_version semver_version_from_in(semver_arena arena, unsigned long major,
+                                      unsigned long minor, unsigned long patch,
+                                      const char *prerelease,
+                                      const char *build) {
+  semver_version_view v;
+  semver_version_view_from(&v, major, minor, patch, prerelease, build);
+  return semver_version_from_view_in(arena, &v);
+}
+
 semver_version semver_version_from(unsigned long major, unsigned long minor,
                                     unsigned long patch, const char *prerelease,
                                     const char *build) {
+  return semver_version_from_in(0, major, minor, patch, prerelease, build);
+}
 
-  semver_version_impl *res;
-  SEMVER_NEW(res, semver_version_impl);
-  res->major = major;
-  res->minor = minor;
-  res->patch = patch;
-  if (prerelease != NULL && strlen(prerelease) > 0) {
-    res->prerelease = semver_strdup(prerelease);
-  } else {
-    res->prerelease = 0;
+semver_version semver_version_init_from_in(semver_arena arena,
+                                           semver_version_storage *mem,
+                                           unsigned long major,
+                                           unsigned long minor,
+                                           unsigned long patch,
+                                           const char *prerelease,
+                                           const char *build) {
+  semver_version_view v;
+  semver_version_view_from(&v, major, minor, patch, prerelease, build);
+  return semver_version_init_view_in(arena, mem, &v);
+}
+
+semver_version semver_version_init_from(semver_version_storage *mem,
+                                        unsigned long major,
+                                        unsigned long minor,
+                                        unsigned long patch,
+                                        const char *prerelease,
+                                        const char *build) {
+  return semver_version_init_from_in(0, mem, major, minor, patch, prerelease,
+                                     build);
+}
+
+semver_version_wrapped semver_version_from_strn_wrapped_in(semver_arena arena,
+                                                           const char *buf,
+                                                           size_t len) {
+  int k;
+  semver_version_wrapped res;
+  semver_version_view v;
+  res.err = 0;
+  res.unwrap.result = 0;
+  if (!buf) {
+    res.err = 1;
+    return res;
   }
-  if (build != NULL && strlen(build) > 0) {
-    res->build = semver_strdup(build);
-  } else {
-    res->build = 0;
+  k = semver_version_parse(buf, len, &v);
+  if (k != SEMVER_OK) {
+    res.err = 1;
+    res.unwrap.code = k;
+    return res;
   }
-  return (semver_version )res;
+  res.unwrap.result = semver_version_from_view_in(arena, &v);
+  if (!res.unwrap.result) {
+    res.err = 1;
+    res.unwrap.code = SEMVER_ERROR_OUT_OF_MEMORY;
+  }
+  return res;
 }
 
-semver_version semver_version_from_string(const char *s) {
-  int k;
-  semver_version_impl *res = 0;
-  if (!s) {
+semver_version semver_version_from_strn_in(semver_arena arena,
+                                           const char *buf, size_t len) {
+  semver_version_wrapped res;
+  res = semver_version_from_strn_wrapped_in(arena, buf, len);
+  if (res.err) {
     return 0;
   }
-  res = (semver_version_impl *)semver_version_new();
-  k = semver_version_from_string_impl(res, s);
-  if (k != SEMVER_OK) {
-    semver_version_delete(res);
+  return res.unwrap.result;
+}
+
+semver_version semver_version_from_strn(const char *buf, size_t len) {
+  return semver_version_from_strn_in(0, buf, len);
+}
+
+semver_version_wrapped semver_version_from_strn_wrapped(const char *buf,
+                                                        size_t len) {
+  return semver_version_from_strn_wrapped_in(0, buf, len);
+}
+
+semver_version semver_version_from_string_in(semver_arena arena,
+                                             const char *s) {
+  if (!s) {
     return 0;
   }
-  return (semver_version )res;
+  return semver_version_from_strn_in(arena, s, strlen(s));
+}
+
+semver_version semver_version_from_string(const char *s) {
+  return semver_version_from_string_in(0, s);
+}
+
+semver_version_wrapped semver_version_from_string_wrapped_in(semver_arena arena,
+                                                             const char *s) {
+  return semver_version_from_strn_wrapped_in(arena, s, s ? strlen(s) : 0);
 }
 
 semver_version_wrapped semver_version_from_string_wrapped(const char *s) {
+  return semver_version_from_string_wrapped_in(0, s);
+}
+
+semver_version semver_version_from_copy_in(semver_arena arena,
+                                           const semver_version _v) {
+  const semver_version_impl *v = (const semver_version_impl *)_v;
+  semver_version_view view;
+  if (v == 0) {
+    return 0;
+  }
+  semver_version_view_of(v, &view);
+  return semver_version_from_view_in(arena, &view);
+}
+
+semver_version semver_version_from_copy(const semver_version _v) {
+  return semver_version_from_copy_in(0, _v);
+}
+
+semver_version_wrapped
+semver_version_init_from_strn_wrapped_in(semver_arena arena,
+                                         semver_version_storage *mem,
+                                         const char *buf, size_t len) {
   int k;
   semver_version_wrapped res;
-  semver_version_impl *impl = 0;
+  semver_version_view v;
   res.err = 0;
   res.unwrap.result = 0;
-  if (!s) {
+  if (!mem || !buf) {
     res.err = 1;
     return res;
   }
-  impl = (semver_version_impl *)semver_version_new();
-  k = semver_version_from_string_impl(impl, s);
+  k = semver_version_parse(buf, len, &v);
   if (k != SEMVER_OK) {
     res.err = 1;
-    res.unwrap.code = -1;
-    semver_version_delete(impl);
     res.unwrap.code = k;
     return res;
   }
-  res.unwrap.result = (semver_version )impl;
+  res.unwrap.result = semver_version_init_view_in(arena, mem, &v);
+  if (!res.unwrap.result) {
+    res.err = 1;
+    res.unwrap.code = SEMVER_ERROR_OUT_OF_MEMORY;
+  }
   return res;
 }
 
-semver_version semver_version_from_copy(const semver_version _v) {
+semver_version_wrapped
+semver_version_init_from_strn_wrapped(semver_version_storage *mem,
+                                      const char *buf, size_t len) {
+  return semver_version_init_from_strn_wrapped_in(0, mem, buf, len);
+}
+
+semver_version semver_version_init_from_strn(semver_version_storage *mem,
+                                             const char *buf, size_t len) {
+  semver_version_wrapped res;
+  res = semver_version_init_from_strn_wrapped_in(0, mem, buf, len);
+  if (res.err) {
+    return 0;
+  }
+  return res.unwrap.result;
+}
+
+semver_version semver_version_init_from_string(semver_version_storage *mem,
+                                               const char *s) {
+  if (!s) {
+    return 0;
+  }
+  return semver_version_init_from_strn(mem, s, strlen(s));
+}
+
+semver_version_wrapped
+semver_version_init_from_string_wrapped_in(semver_arena arena,
+                                           semver_version_storage *mem,
+                                           const char *s) {
+  return semver_version_init_from_strn_wrapped_in(arena, mem, s,
+                                                  s ? strlen(s) : 0);
+}
+
+semver_version_wrapped
+semver_version_init_from_string_wrapped(semver_version_storage *mem,
+                                        const char *s) {
+  return semver_version_init_from_string_wrapped_in(0, mem, s);
+}
+
+semver_version semver_version_init_from_copy_in(semver_arena arena,
+                                                semver_version_storage *mem,
+                                                const semver_version _v) {
   const semver_version_impl *v = (const semver_version_impl *)_v;
-  semver_version_impl *res;
+  semver_version_view view;
   if (v == 0) {
     return 0;
   }
-  res = (semver_version_impl *)semver_version_new();
+  semver_version_view_of(v, &view);
+  return semver_version_init_view_in(arena, mem, &view);
+}
 
-  res->major = v->major;
-  res->minor = v->minor;
-  res->patch = v->patch;
-  res->prerelease = 0;
-  res->build = 0;
+semver_version semver_version_init_from_copy(semver_version_storage *mem,
+                                             const semver_version _v) {
+  return semver_version_init_from_copy_in(0, mem, _v);
+}
 
-  if (v->prerelease != 0) {
-    res->prerelease = semver_strdup(v->prerelease);
+void semver_version_destroy(semver_version _self) {
+  semver_version_impl *self = (semver_version_impl *)_self;
+  if (self == NULL) {
+    return;
+  }
+  if (self->flags & SEMVER_STORAGE_ARENA) {
+    /* released with the arena */
+    return;
   }
-  if (v->build != 0) {
-    res->build = semver_strdup(v->build);
+  if (self->spill != NULL) {
+    semver_free(self->spill);
+    self->spill = NULL;
   }
-
-  return (semver_version)res;
 }
 
 void semver_version_delete(semver_version _self) {
@@ -208,15 +565,12 @@ void semver_version_delete(semver_version _self) {
   if (self == NULL) {
     return;
   }
-  if (self->prerelease != NULL) {
-    free(self->prerelease);
-    self->prerelease = NULL;
-  }
-  if (self->build != NULL) {
-    free(self->build);
-    self->build = NULL;
+  semver_version_destroy(_self);
+  if (self->flags & (SEMVER_STORAGE_CALLER | SEMVER_STORAGE_ARENA)) {
+    /* storage is owned by the caller or an arena */
+    return;
   }
-  free(self);
+  semver_free(self);
 }
 
 unsigned long semver_version_get_major(const semver_version _self) {
@@ -245,167 +599,167 @@ void semver_version_get(const semver_version _self, unsigned long *major,
 size_t semver_version_copy_prerelease(const semver_version _self, char *str,
                                       size_t size) {
   semver_version_impl *self = (semver_version_impl *)_self;
+  const char *prerelease;
   if (!str || size == 0) {
     return 0;
   }
-  if (self->prerelease == NULL) {
+  prerelease = semver_version_prerelease_str(self);
+  if (prerelease == NULL) {
     str[0] = 0;
     return 0;
   }
-  strncpy(str, self->prerelease, size);
+  strncpy(str, prerelease, size);
   return 1;
 }
 
 size_t semver_version_copy_build(const semver_version _self, char *str,
                                  size_t size) {
   semver_version_impl *self = (semver_version_impl *)_self;
+  const char *build;
   if (!str || size == 0) {
     return 0;
   }
-  if (self->build == NULL) {
+  build = semver_version_build_str(self);
+  if (build == NULL) {
     str[0] = 0;
     return 0;
   }
-  strncpy(str, self->build, size);
+  strncpy(str, build, size);
   return 1;
 }
 
 int semver_version_from_string_impl(semver_version _self, const char *s) {
-  char scratch[SEMVER_MAXLEN];
-  char *p = s;
-  char *ptr;
-  char *w = scratch;
-
   semver_version_impl *self = (semver_version_impl *)_self;
-  int n = strlen(s);
-  if (n >= SEMVER_MAXLEN) {
-    return SEMVER_ERROR_PARSE_TOO_LONG;
+  semver_version_view v;
+  size_t n;
+  int k;
+
+  k = semver_version_parse(s, strlen(s), &v);
+  if (k != SEMVER_OK) {
+    return k;
   }
 
-  memset(scratch, 0,sizeof(scratch));
-  w = &scratch[0];
-  do {
-    if (p == 0 || *p == 0) {
-      return SEMVER_ERROR_PARSE_PREMATURE_EOS;
-    }
-    if (*p == '.') {
-      p++;
-      if (strlen(scratch) > 1 && *scratch == '0') {
-        return SEMVER_ERROR_PARSE_NOT_ALLOWED_HERE;
-      }
-      /* major in scratch, take */
-      self->major = strtoul(scratch, &ptr, 10);
-      break;
-    }
-    if (*p >= '0' && *p <= '9') {
-      *w++ = *p++;
-      continue;
+  n = semver_version_view_ext_size(&v);
+  if (self->spill != NULL) {
+    semver_free(self->spill);
+    self->spill = NULL;
+  }
+  if (n > self->capacity) {
+    /* does not fit behind the header */
+    self->spill = semver_malloc(n);
+    if (!self->spill) {
+      return SEMVER_ERROR_OUT_OF_MEMORY;
     }
-    /* non-matching char */
-    return SEMVER_ERROR_PARSE_NOT_ALLOWED_HERE;
-
-  } while (1);
+  }
+  semver_version_view_fill(self, &v, SEMVER_EXT(self));
+  return SEMVER_OK;
+}
 
-  w = scratch;
-  memset(scratch, 0, n + 1);
-  do {
-    if (*p == 0) {
-      return SEMVER_ERROR_PARSE_PREMATURE_EOS;
-    }
-    if (*p == '.') {
-      p++;
-      if (strlen(scratch) > 1 && *scratch == '0') {
-        return SEMVER_ERROR_PARSE_NOT_ALLOWED_HERE;
-      }
-      /* minor in scratch, take */
-      self->minor = strtoul(scratch, &ptr, 10);
-      break;
-    }
-    if (*p >= '0' && *p <= '9') {
-      *w++ = *p++;
-      continue;
+/**
+ * semver_version_parse_num accumulates a numeric component starting at *pp
+ * until the first non-digit or end, and advances *pp behind it. Rejects
+ * leading zeros and values exceeding unsigned long. Sets *ndigits to the
+ * number of digits read, which may be 0.
+ */
+int semver_version_parse_num(const char **pp, const char *end,
+                             unsigned long *out, size_t *ndigits) {
+  const char *p = *pp;
+  unsigned long x = 0;
+  unsigned int d;
+
+  while (p != end && (d = (unsigned int)((unsigned char)*p - '0')) <= 9) {
+    if (x > (ULONG_MAX - d) / 10) {
+      return SEMVER_ERROR_PARSE_OVERFLOW;
     }
+    x = x * 10 + d;
+    p++;
+  }
+  *ndigits = p - *pp;
+  if (*ndigits > 1 && **pp == '0') {
     return SEMVER_ERROR_PARSE_NOT_ALLOWED_HERE;
-  } while (1);
+  }
+  *pp = p;
+  *out = x;
+  return SEMVER_OK;
+}
 
-  w = scratch;
-  memset(scratch, 0,sizeof(scratch));
-  do {
-    size_t strlen_scratch = strlen(scratch);
-    if (*p == 0) {
+int semver_version_parse(const char *s, size_t n, semver_version_view *v) {
+  const char *p = s;
+  const char *end = s + n;
+  unsigned long *parts[3];
+  size_t nd;
+  int i, k;
 
-      if (strlen_scratch > 1 && *scratch == '0') {
-        /* leading zero */
-        return SEMVER_ERROR_PARSE_NOT_ALLOWED_HERE;
-      }
-      if (strlen_scratch == 0) {
-        /* handle e.g. "1.2.". we consumed the last '.', scratch is empty
-           but this is not a valid semver. */
+  if (n >= SEMVER_MAXLEN) {
+    return SEMVER_ERROR_PARSE_TOO_LONG;
+  }
+
+  v->prerelease = 0;
+  v->prerelease_len = 0;
+  v->n_idents = 0;
+  v->build = 0;
+  v->build_len = 0;
+
+  parts[0] = &v->major;
+  parts[1] = &v->minor;
+  parts[2] = &v->patch;
+  for (i = 0; i < 3; i++) {
+    k = semver_version_parse_num(&p, end, parts[i], &nd);
+    if (k != SEMVER_OK) {
+      return k;
+    }
+    if (p == end) {
+      /* e.g. "1.2." or "1.2". Only a complete patch may end the input */
+      if (i < 2 || nd == 0) {
         return SEMVER_ERROR_PARSE_PREMATURE_EOS;
       }
-      self->patch = strtoul(scratch, &ptr, 10);
       /* patch version read, minimal semver reached */
       return SEMVER_OK;
     }
-    if ((*p == '-') || (*p == '+')) {
-      if (strlen_scratch > 1 && *scratch == '0') {
+    if (nd == 0) {
+      return SEMVER_ERROR_PARSE_NOT_ALLOWED_HERE;
+    }
+    if (i < 2) {
+      if (*p != '.') {
         return SEMVER_ERROR_PARSE_NOT_ALLOWED_HERE;
       }
-      /* patch read, more to follow */
-      self->patch = strtoul(scratch, &ptr, 10);
-      break;
-    }
-    if (*p >= '0' && *p <= '9') {
-      *w++ = *p++;
-      continue;
+      p++;
+    } else if ((*p != '-') && (*p != '+')) {
+      return SEMVER_ERROR_PARSE_NOT_ALLOWED_HERE;
     }
-    return SEMVER_ERROR_PARSE_NOT_ALLOWED_HERE;
-  } while (1);
+  }
 
   if (*p == '-') {
     p++;
 
-    /* prerelease to follow .. */
-
-    w = scratch;
-    memset(scratch, 0, sizeof(scratch));
-    do {
-      if (*p == 0) {
-        self->prerelease = semver_strdup(scratch);
-        return SEMVER_OK; /* at end */
-      }
-      if (*p == '+') {
-        self->prerelease = semver_strdup(scratch);
-        /* prerelease read, more to follow */
-        break;
-      }
-      if ((*p >= '0' && *p <= '9') || (*p >= 'a' && *p <= 'z') ||
-          (*p >= 'A' && *p <= 'Z') || (*p == '-') || (*p == '.')) {
-        *w++ = *p++;
-        continue;
-      }
+    /* prerelease to follow, taken in place from the input. It ends at '+',
+     * the first byte not within its character class */
+    v->prerelease = p;
+    v->n_idents = 1;
+    p += semver_scan_span(p, end - p, SEMVER_SCAN_IDENT, &v->n_idents);
+    v->prerelease_len = p - v->prerelease;
+    if (v->prerelease_len == 0) {
+      v->n_idents = 0;
+    }
+    if (p == end) {
+      return SEMVER_OK; /* at end */
+    }
+    if (*p != '+') {
       return SEMVER_ERROR_PARSE_NOT_ALLOWED_HERE;
-    } while (1);
+    }
   }
 
   if (*p == '+') {
     p++;
 
     /* build strign to follow here */
-    w = scratch;
-    memset(scratch, 0, sizeof(scratch));
-    do {
-      if (*p == 0) {
-        self->build = semver_strdup(scratch);
-        return SEMVER_OK;
-      }
-      if ((*p >= '0' && *p <= '9') || (*p >= 'a' && *p <= 'z') ||
-          (*p >= 'A' && *p <= 'Z') || (*p == '-') || (*p == '.')) {
-        *w++ = *p++;
-        continue;
-      }
+    v->build = p;
+    p += semver_scan_span(p, end - p, SEMVER_SCAN_IDENT, 0);
+    if (p != end) {
       return SEMVER_ERROR_PARSE_NOT_ALLOWED_HERE;
-    } while (1);
+    }
+    v->build_len = p - v->build;
+    return SEMVER_OK;
   }
 
   return SEMVER_ERROR_STRUCTURE;
@@ -415,27 +769,30 @@ int semver_version_from_string_impl(semver_version _self, const char *s) {
 size_t semver_version_snprint(const semver_version _self, char *str,
                               size_t size) {
   const semver_version_impl *self = (semver_version_impl *)_self;
+  const char *prerelease, *build;
   if (str == 0 || size <= 0) {
     return 0;
   }
   if (self == 0) {
     return 0;
   }
-  if (self->prerelease == NULL && self->build == NULL) {
+  prerelease = semver_version_prerelease_str(self);
+  build = semver_version_build_str(self);
+  if (prerelease == NULL && build == NULL) {
     return snprintf(str, size, "%lu.%lu.%lu", self->major, self->minor,
                     self->patch);
   }
-  if (self->prerelease != NULL && self->build == NULL) {
+  if (prerelease != NULL && build == NULL) {
     return snprintf(str, size, "%lu.%lu.%lu-%s", self->major, self->minor,
-                    self->patch, self->prerelease);
+                    self->patch, prerelease);
   }
-  if (self->prerelease == NULL && self->build != NULL) {
+  if (prerelease == NULL && build != NULL) {
     return snprintf(str, size, "%lu.%lu.%lu+%s", self->major, self->minor,
-                    self->patch, self->build);
+                    self->patch, build);
   }
-  if (self->prerelease != NULL && self->build != NULL) {
+  if (prerelease != NULL && build != NULL) {
     return snprintf(str, size, "%lu.%lu.%lu-%s+%s", self->major, self->minor,
-                    self->patch, self->prerelease, self->build);
+                    self->patch, prerelease, build);
   }
   return -1;
 }
@@ -443,61 +800,93 @@ size_t semver_version_snprint(const semver_version _self, char *str,
 
 size_t semver_version_sprint(const semver_version _self, char *str) {
   const semver_version_impl *self = (semver_version_impl *)_self;
+  const char *prerelease, *build;
   if (str == 0 || self == 0) {
     return 0;
   }
-  
-  if (self->prerelease == 0 && self->build == 0) {
+  prerelease = semver_version_prerelease_str(self);
+  build = semver_version_build_str(self);
+
+  if (prerelease == 0 && build == 0) {
     int k = sprintf(str, "%lu.%lu.%lu", self->major, self->minor, self->patch);
     return k;
   }
-  if (self->prerelease != 0 && self->build == 0) {
+  if (prerelease != 0 && build == 0) {
     return sprintf(str, "%lu.%lu.%lu-%s", self->major, self->minor, self->patch,
-                   self->prerelease);
+                   prerelease);
   }
-  if (self->prerelease == 0 && self->build != 0) {
+  if (prerelease == 0 && build != 0) {
     return sprintf(str, "%lu.%lu.%lu+%s", self->major, self->minor, self->patch,
-                   self->build);
+                   build);
   }
-  if (self->prerelease != 0 && self->build != 0) {
+  if (prerelease != 0 && build != 0) {
     return sprintf(str, "%lu.%lu.%lu-%s+%s", self->major, self->minor,
-                   self->patch, self->prerelease, self->build);
+                   self->patch, prerelease, build);
   }
   return -1;
 }
 
-int count_dots(const char *s) {
-  int na = 0;
-  while (s && *s++ != 0) {
-    na += (*s == '.') ? 1 : 0;
-  }
-  return na;
-}
-
-int atoi_checked(const char *s, unsigned long *res) {
-  const char *p = s;
-  const size_t max_num_len = 6;
-  size_t i = 0;
-  char *ptr;
-
-  if (s == NULL) {
+/**
+ * semver_version_ident_is_numeric checks if an identifier of length n consists
+ * of digits only. Empty identifiers are not numeric.
+ */
+int semver_version_ident_is_numeric(const char *s, size_t n) {
+  size_t i;
+  if (n == 0) {
     return 0;
   }
-
-  while (*p != 0) {
-    if (*p >= '0' && *p <= '9' && i <= max_num_len) {
-      /* ok */
-    } else {
-      /* not non-digit or too long */
+  for (i = 0; i < n; i++) {
+    if (s[i] < '0' || s[i] > '9') {
       return 0;
     }
-    p++;
-    i++;
   }
+  return 1;
+}
 
-  *res = strtoul(s, &ptr, 10);
+/**
+ * semver_version_ident_cmp compares two single prerelease identifiers a, b of
+ * length na, nb (not NUL-terminated). Precedence rules, see semver 2.0.0 11.4:
+ * - numeric identifiers are compared numerically, regardless of their length
+ * - alphanumeric identifiers are compared lexically in ASCII sort order
+ * - numeric identifiers always have lower precedence than alphanumeric ones
+ * returns <0, 0, >0
+ */
+int semver_version_ident_cmp(const char *a, size_t na, const char *b,
+                             size_t nb) {
+  int an = semver_version_ident_is_numeric(a, na);
+  int bn = semver_version_ident_is_numeric(b, nb);
+  int k;
 
-  return 1;
+  if (an && bn) {
+    /* skip leading zeros, then the longer number is the larger one */
+    while (na > 1 && *a == '0') {
+      a++;
+      na--;
+    }
+    while (nb > 1 && *b == '0') {
+      b++;
+      nb--;
+    }
+    if (na != nb) {
+      return (na < nb) ? -1 : 1;
+    }
+    return memcmp(a, b, na);
+  }
+  if (an) {
+    return -1;
+  }
+  if (bn) {
+    return 1;
+  }
+
+  k = memcmp(a, b, (na < nb) ? na : nb);
+  if (k != 0) {
+    return k;
+  }
+  if (na != nb) {
+    return (na < nb) ? -1 : 1;
+  }
+  return 0;
 }
 
 /**
@@ -510,124 +899,109 @@ int atoi_checked(const char *s, unsigned long *res) {
  * - <0 if a < b
  * - >0 if a > b
  * - 0 if both are equal
+ * The absolute value of the result is the (1-based) index of the part where
+ * a and b differ. Both strings are walked in place, no memory is allocated.
  */
 int semver_version_prerelease_cmp(const char *a, const char *b) {
-  int res = 0;
-  int i = 0;
-  char *p;
-  int na = 0;
-  char *_a = NULL;
-  char **arr_a = NULL;
-  int nb = 0;
-  char *_b = NULL;
-  char **arr_b = NULL;
+  int i = 1;
+  int k;
+  size_t na, nb;
 
   /* simple checks */
-  if (a == NULL && b == NULL) {
-    return 0;
-  }
-  if (a != NULL && strlen(a) == 0 && b != NULL && strlen(b) == 0) {
+  if ((a == NULL || *a == 0) && (b == NULL || *b == 0)) {
     return 0;
   }
-  if (a == NULL || (a != NULL && strlen(a) == 0)) {
+  if (a == NULL || *a == 0) {
     return 1;
   }
-  if (b == NULL || (b != NULL && strlen(b) == 0)) {
+  if (b == NULL || *b == 0) {
     return -1;
   }
 
-  /* split each string by '.' */
-  na = count_dots(a) + 1;
-  _a = semver_strdup(a);
+  /* compare part-wise, each part ends at '.' or end of string */
+  do {
+    na = strcspn(a, ".");
+    nb = strcspn(b, ".");
 
-  arr_a = (char **)calloc(na, sizeof(char *));
-  p = _a;
-  i = 0;
-  arr_a[i] = p;
-  while (*p != 0) {
-    if (*p == '.') {
-      *p = 0; /* terminate this part */
-      i++;
-      p++;
-      arr_a[i] = p;
+    k = semver_version_ident_cmp(a, na, b, nb);
+    if (k < 0) {
+      return i * (-1);
     }
-    p++;
+    if (k > 0) {
+      return i;
+    }
+    /* == 0, both parts are equal, cont. */
+    a += na;
+    b += nb;
+    if (*a == 0 || *b == 0) {
+      break;
+    }
+    a++;
+    b++;
+    i++;
+  } while (1);
+
+  /* if we got here, both are considered equal up to this point
+     if any of the two is LONGER (i.e. has still parts to come), then the
+     OTHER (shorter) one has precendence */
+  if (*a != 0) {
+    return i + 1;
+  }
+  if (*b != 0) {
+    return (i + 1) * (-1);
   }
+  return 0;
+}
 
-  /* -- b
-    split each string by '.' */
-  nb = count_dots(b) + 1;
-  _b = semver_strdup(b);
+/**
+ * semver_version_idents_cmp compares the prerelease identifiers of a and b,
+ * with the same precedence rules and results as
+ * semver_version_prerelease_cmp. Numeric identifiers have been decoded at
+ * construction time, so in most cases no text needs to be scanned.
+ */
+int semver_version_idents_cmp(const semver_version_impl *a,
+                              const semver_version_impl *b) {
+  const char *pa = semver_version_prerelease_str(a);
+  const char *pb = semver_version_prerelease_str(b);
+  const semver_version_ident *ia = SEMVER_IDENTS(a);
+  const semver_version_ident *ib = SEMVER_IDENTS(b);
+  size_t i;
+  int k;
 
-  arr_b = (char **)calloc(nb, sizeof(char *));
-  p = _b;
-  i = 0;
-  arr_b[i] = p;
-  while (*p != 0) {
-    if (*p == '.') {
-      *p = 0;
-      i++;
-      p++;
-      arr_b[i] = p;
-    }
-    p++;
+  if (a->n_idents == 0 && b->n_idents == 0) {
+    return 0;
+  }
+  if (a->n_idents == 0) {
+    return 1;
+  }
+  if (b->n_idents == 0) {
+    return -1;
   }
 
-  /* from here we can compare arr_a and arr_b, part-wise */
-  i = 0;
-  while (i < na && i < nb) {
-    unsigned long av = 0, bv = 0;
-    int k = 0;
-
-    if (i >= na) {
-      break;
-    }
-    if (i >= nb) {
-      break;
-    }
-    /* if both parts are numbers, compare numerically; lexically otherwise */
-    k = 0;
-    if (atoi_checked(arr_a[i], &av) && atoi_checked(arr_b[i], &bv)) {
-      if (av < bv) {
-        k = -1;
-      }
-      if (av > bv) {
-        k = 1;
-      }
+  for (i = 0; i < a->n_idents && i < b->n_idents; i++) {
+    if (ia[i].kind == SEMVER_IDENT_NUMERIC &&
+        ib[i].kind == SEMVER_IDENT_NUMERIC) {
+      k = (ia[i].num < ib[i].num) ? -1 : (ia[i].num > ib[i].num);
     } else {
-      k = strcmp(arr_a[i], arr_b[i]);
+      k = semver_version_ident_cmp(pa, ia[i].len, pb, ib[i].len);
     }
     if (k < 0) {
-      res = (i + 1) * (-1);
-      goto cleanup;
+      return (int)(i + 1) * (-1);
     }
     if (k > 0) {
-      res = (i + 1);
-      goto cleanup;
+      return (int)(i + 1);
     }
-    /* == 0, both parts are equal, cont. */
-
-    i++;
+    pa += ia[i].len + 1;
+    pb += ib[i].len + 1;
   }
-  /* if we got here, both arr's are considered equal up to this point
-     if any of the two is LONGER (i.e. has still elements to come), then the
-     OTHER (shorter) one has precendence */
-  res = 0;
-  if (na > nb) {
-    res = (i + 1);
-    goto cleanup;
+
+  if (a->n_idents > b->n_idents) {
+    return (int)(i + 1);
   }
-  if (nb > na) {
-    res = (i + 1) * (-1);
+  if (b->n_idents > a->n_idents) {
+    return (int)(i + 1) * (-1);
   }
-
-cleanup:
-  free(arr_b);
-  free(_b);
-  free(arr_a);
-  free(_a);
-
-  return res;
+  return 0;
 }
 
 /**
@@ -663,7 +1037,7 @@ int semver_version_cmp(const semver_version _a, const semver_version _b) {
     return 3;
   }
   /* patch equals too, compare prereleases */
-  p = semver_version_prerelease_cmp(a->prerelease, b->prerelease);
+  p = semver_version_idents_cmp(a, b);
   if (p < 0) {
     return -2;
   }
@@ -672,3 +1046,145 @@ int semver_version_cmp(const semver_version _a, const semver_version _b) {
   }
   return 0;
 }
+
+/* widths of the minor and patch fields of semver_version_key.lo, the lowest
+ * bit is the release bit */
+#if ULONG_MAX > 0xffffffffUL
+#define SEMVER_KEY_PATCH_BITS 31
+#else
+#define SEMVER_KEY_PATCH_BITS 15
+#endif
+#define SEMVER_KEY_MINOR_MAX (ULONG_MAX >> (SEMVER_KEY_PATCH_BITS + 1))
+#define SEMVER_KEY_PATCH_MAX ((1UL << SEMVER_KEY_PATCH_BITS) - 1)
+
+semver_version_key semver_version_key_of(const semver_version _self) {
+  const semver_version_impl *self = (semver_version_impl *)_self;
+  semver_version_key k;
+
+  k.hi = self->major;
+  /* values that do not fit saturate their field and all fields below it,
+   * which keeps the key order consistent with semver_version_cmp */
+  if (self->minor >= SEMVER_KEY_MINOR_MAX) {
+    k.lo = ULONG_MAX;
+  } else if (self->patch >= SEMVER_KEY_PATCH_MAX) {
+    k.lo = (self->minor << (SEMVER_KEY_PATCH_BITS + 1)) |
+           (SEMVER_KEY_PATCH_MAX << 1) | 1UL;
+  } else {
+    k.lo = (self->minor << (SEMVER_KEY_PATCH_BITS + 1)) | (self->patch << 1) |
+           (self->n_idents == 0 ? 1UL : 0UL);
+  }
+  return k;
+}
+
+int semver_version_key_exact(const semver_version _self) {
+  const semver_version_impl *self = (semver_version_impl *)_self;
+
+  return self->n_idents == 0 && self->minor < SEMVER_KEY_MINOR_MAX &&
+         self->patch < SEMVER_KEY_PATCH_MAX;
+}
+
+int semver_version_key_cmp(const semver_version_key *a,
+                           const semver_version_key *b) {
+  if (a->hi != b->hi) {
+    return a->hi < b->hi ? -1 : 1;
+  }
+  return (a->lo > b->lo) - (a->lo < b->lo);
+}
+
+int semver_version_cmp_keyed(const semver_version a,
+                             const semver_version_key *ka,
+                             const semver_version b,
+                             const semver_version_key *kb) {
+  int k = semver_version_key_cmp(ka, kb);
+  if (k != 0) {
+    return k;
+  }
+  return semver_version_cmp(a, b);
+}
+
+/* multiply-xorshift steps of the hash functions, see MurmurHash3 */
+#if ULONG_MAX > 0xffffffffUL
+#define SEMVER_HASH_STEP(h, x)                                                 \
+  ((h) = ((h) ^ (x)) * 0x9e3779b97f4a7c15UL, (h) ^= (h) >> 32)
+#define SEMVER_HASH_FINAL(h)                                                   \
+  ((h) ^= (h) >> 33, (h) *= 0xff51afd7ed558ccdUL, (h) ^= (h) >> 33,            \
+   (h) *= 0xc4ceb9fe1a85ec53UL, (h) ^= (h) >> 33)
+#else
+#define SEMVER_HASH_STEP(h, x)                                                 \
+  ((h) = ((h) ^ (x)) * 0x9e3779b1UL, (h) ^= (h) >> 16)
+#define SEMVER_HASH_FINAL(h)                                                   \
+  ((h) ^= (h) >> 16, (h) *= 0x85ebca6bUL, (h) ^= (h) >> 13,                    \
+   (h) *= 0xc2b2ae35UL, (h) ^= (h) >> 16)
+#endif
+
+/**
+ * semver_version_hash_bytes mixes n bytes of s into h, a word at a time.
+ */
+unsigned long semver_version_hash_bytes(unsigned long h, const char *s,
+                                        size_t n) {
+  unsigned long w;
+
+  SEMVER_HASH_STEP(h, (unsigned long)n);
+  for (; n >= sizeof(w); n -= sizeof(w), s += sizeof(w)) {
+    memcpy(&w, s, sizeof(w));
+    SEMVER_HASH_STEP(h, w);
+  }
+  if (n > 0) {
+    w = 0;
+    memcpy(&w, s, n);
+    SEMVER_HASH_STEP(h, w);
+  }
+  return h;
+}
+
+/**
+ * semver_version_hash_of hashes the precedence-relevant parts of a version:
+ * numbers and prerelease identifiers. Numeric identifiers are hashed by
+ * value, so that ones comparing equal, e.g. "01" and "1", hash equally.
+ */
+unsigned long semver_version_hash_of(const semver_version_impl *self) {
+  const semver_version_ident *ident = SEMVER_IDENTS(self);
+  const char *p;
+  unsigned long h = 0;
+  size_t i, j;
+
+  SEMVER_HASH_STEP(h, self->major);
+  SEMVER_HASH_STEP(h, self->minor);
+  SEMVER_HASH_STEP(h, self->patch);
+  SEMVER_HASH_STEP(h, (unsigned long)self->n_idents);
+  p = semver_version_prerelease_str(self);
+  for (i = 0; i < self->n_idents; i++) {
+    if (ident[i].kind == SEMVER_IDENT_NUMERIC) {
+      SEMVER_HASH_STEP(h, (unsigned long)ident[i].num);
+    } else if (ident[i].kind == SEMVER_IDENT_BIGNUM) {
+      for (j = 0; j + 1 < ident[i].len && p[j] == '0'; j++) {
+      }
+      h = semver_version_hash_bytes(h, p + j, ident[i].len - j);
+    } else {
+      /* kind as a prefix, alphanumeric identifiers never equal numbers */
+      SEMVER_HASH_STEP(h, 1UL);
+      h = semver_version_hash_bytes(h, p, ident[i].len);
+    }
+    p += ident[i].len + 1;
+  }
+  return h;
+}
+
+unsigned long semver_version_hash(const semver_version _self) {
+  unsigned long h = semver_version_hash_of((semver_version_impl *)_self);
+  SEMVER_HASH_FINAL(h);
+  return h;
+}
+
+unsigned long semver_version_hash_exact(const semver_version _self) {
+  const semver_version_impl *self = (semver_version_impl *)_self;
+  unsigned long h = semver_version_hash_of(self);
+
+  SEMVER_HASH_STEP(h, (unsigned long)(self->flags & SEMVER_HAS_BUILD));
+  if (self->flags & SEMVER_HAS_BUILD) {
+    h = semver_version_hash_bytes(h, semver_version_build_str(self),
+                                  self->build_len);
+  }
+  SEMVER_HASH_FINAL(h);
+  return h;
+}
@@ -0,0 +1,440 @@
+/*
+ * MIT License
+ *
+ * Copyright 2023 @aschmidt75
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*
+ * semver_impl.h is internal to the library. It describes the memory layout of
+ * semver_version and functions shared between the modules. Not installed.
+ */
+#ifndef __SEMVER_IMPL_H
+#define __SEMVER_IMPL_H
+
+#include <stdlib.h>
+
+#include "semver.h"
+#include "semverarena.h"
+#include "semverreq.h"
+
+/**
+ * semver_malloc, semver_realloc and semver_free go through the allocator set
+ * by semver_set_allocator. All memory management of the library uses them.
+ */
+void *semver_malloc(size_t size);
+void *semver_realloc(void *ptr, size_t size);
+void semver_free(void *ptr);
+
+/**
+ * semver_alloc_in allocates from arena if given, via semver_malloc otherwise.
+ * Returns NULL if out of memory.
+ */
+void *semver_alloc_in(semver_arena arena, size_t size);
+
+/**
+ * semver_version_ident is a single dot-separated prerelease identifier,
+ * split and classified once when a version is constructed. Identifiers are
+ * stored in order, each one starts one byte ('.') after the end of the
+ * previous one.
+ */
+typedef struct {
+  /* Value of a numeric identifier, valid for SEMVER_IDENT_NUMERIC only */
+  unsigned int num;
+
+  /* Length of the identifier in the prerelease string */
+  unsigned int len : 30;
+
+  /* one of SEMVER_IDENT_* */
+  unsigned int kind : 2;
+} semver_version_ident;
+
+/* alphanumeric identifier, compared lexically */
+#define SEMVER_IDENT_ALNUM 0
+/* numeric identifier, decoded into num */
+#define SEMVER_IDENT_NUMERIC 1
+/* numeric identifier too large for an unsigned int, compared as digits */
+#define SEMVER_IDENT_BIGNUM 2
+
+/**
+ * semver_version_impl
+ *
+ * implements a semantic versioning (semver) record according to semver 2.0.0
+ * @see https://semver.org/spec/v2.0.0.html
+ *
+ * A version is laid out as a single block: this header is directly followed
+ * by its trailing storage, which holds the prerelease identifiers, then the
+ * NUL-terminated prerelease and build strings (if present). All of them are
+ * addressed relative to the trailing storage, see SEMVER_EXT.
+ */
+typedef struct {
+
+  /* Major version number */
+  unsigned long major;
+
+  /* Minor version number */
+  unsigned long minor;
+
+  /* Patch number */
+  unsigned long patch;
+
+  /* Trailing storage if it did not fit behind the header, NULL otherwise */
+  char *spill;
+
+  /* Number of bytes available for trailing storage behind the header */
+  unsigned int capacity;
+
+  /* Number of prerelease identifiers */
+  unsigned int n_idents;
+
+  /* Length of prerelease and build string, valid if flagged in flags */
+  unsigned int prerelease_len;
+  unsigned int build_len;
+
+  /* SEMVER_HAS_*, SEMVER_STORAGE_* */
+  unsigned int flags;
+
+} semver_version_impl;
+
+#define SEMVER_HAS_PRERELEASE 1
+#define SEMVER_HAS_BUILD 2
+/* version lives in caller-provided storage, see semver_version_storage */
+#define SEMVER_STORAGE_CALLER 4
+/* version and its trailing storage are owned by a semver_arena */
+#define SEMVER_STORAGE_ARENA 8
+#define SEMVER_STORAGE_MASK (SEMVER_STORAGE_CALLER | SEMVER_STORAGE_ARENA)
+
+/* caller-provided storage must be able to hold at least the header */
+typedef char semver_version_storage_size_check
+    [(sizeof(semver_version_impl) < SEMVER_VERSION_STORAGE_SIZE) ? 1 : -1];
+
+/* trailing storage of a version */
+#define SEMVER_EXT(self)                                                       \
+  ((self)->spill ? (self)->spill : (char *)((self) + 1))
+
+/* prerelease identifiers of a version */
+#define SEMVER_IDENTS(self) ((semver_version_ident *)SEMVER_EXT(self))
+
+/**
+ * semver_version_view describes the parts of a version without owning them,
+ * e.g. as the result of parsing an input string. Strings are not
+ * NUL-terminated, NULL strings are absent.
+ */
+typedef struct {
+  unsigned long major;
+  unsigned long minor;
+  unsigned long patch;
+  const char *prerelease;
+  size_t prerelease_len;
+  const char *build;
+  size_t build_len;
+  /* number of prerelease identifiers */
+  size_t n_idents;
+} semver_version_view;
+
+/**
+ * semver_version_from_string_impl parses a given string into the semver version
+ * record. Returns SEMVER_OK for correctly processed semver strings, or an error
+ * code. May allocated memory for prerelease and build strings, use
+ * semver_version_delete. Do not call multiple times on existing parsed
+ * structures, may leak memory.
+ */
+int semver_version_from_string_impl(semver_version self, const char *s);
+
+/**
+ * semver_version_parse parses a given string of length n (not necessarily
+ * NUL-terminated) into a view of its parts. Returns SEMVER_OK for correctly
+ * processed semver strings, or an error code. The view points into s.
+ */
+int semver_version_parse(const char *s, size_t n, semver_version_view *v);
+
+/* character classes of semver_scan_span */
+/* prerelease and build identifiers and their separators: [0-9A-Za-z.-] */
+#define SEMVER_SCAN_IDENT 0
+/* any character of a version string: [0-9A-Za-z.+-] */
+#define SEMVER_SCAN_VERSION 1
+
+/**
+ * semver_scan_span returns the length of the longest prefix of s[0..n) whose
+ * bytes are within character class cls, see semverscan.c. Adds the number of
+ * '.' within the prefix to *dots if given. Uses vector instructions where
+ * available, semver_scan_span_scalar otherwise; both return identical
+ * results.
+ */
+size_t semver_scan_span(const char *s, size_t n, int cls, size_t *dots);
+size_t semver_scan_span_scalar(const char *s, size_t n, int cls,
+                               size_t *dots);
+
+/**
+ * semver_version_tokenize splits a prerelease string of length n into
+ * identifiers, see semver.c. Returns their number, idents may be NULL.
+ */
+size_t semver_version_tokenize(const char *s, size_t n,
+                               semver_version_ident *idents);
+
+/**
+ * semver_version_ident_is_numeric checks if an identifier of length n
+ * consists of digits only. Empty identifiers are not numeric.
+ */
+int semver_version_ident_is_numeric(const char *s, size_t n);
+
+/**
+ * semver_version_parse_num parses a numeric version component at *pp,
+ * see semver.c
+ */
+int semver_version_parse_num(const char **pp, const char *end,
+                             unsigned long *out, size_t *ndigits);
+
+/**
+ * semver_version_prerelease_str returns the NUL-terminated prerelease string
+ * of a version, or NULL.
+ */
+const char *semver_version_prerelease_str(const semver_version_impl *self);
+
+/**
+ * semver_version_prerelease_cmp compares two prerelease strings by
+ * precedence, NULL or empty for none, see semver.c.
+ */
+int semver_version_prerelease_cmp(const char *a, const char *b);
+
+/**
+ * semver_version_build_str returns the NUL-terminated build string of a
+ * version, or NULL.
+ */
+const char *semver_version_build_str(const semver_version_impl *self);
+
+/**
+ * semver_version_view_of returns a view of an existing version
+ */
+void semver_version_view_of(const semver_version_impl *self,
+                            semver_version_view *v);
+
+/**
+ * semver_version_from_view_in allocates a new version as a single block and
+ * copies the contents of the view into it. Allocates from arena if given,
+ * from the heap otherwise.
+ */
+semver_version semver_version_from_view_in(semver_arena arena,
+                                           const semver_version_view *v);
+
+/**
+ * semver_version_init_view_in initializes a version in caller-provided
+ * storage and copies the contents of the view into it. Trailing storage that
+ * does not fit into mem is allocated separately, from arena if given.
+ */
+semver_version semver_version_init_view_in(semver_arena arena,
+                                           semver_version_storage *mem,
+                                           const semver_version_view *v);
+
+/**
+ * semver_version_init_from_strn_wrapped_in is
+ * semver_version_init_from_strn_wrapped with trailing storage allocated from
+ * arena if given.
+ */
+semver_version_wrapped
+semver_version_init_from_strn_wrapped_in(semver_arena arena,
+                                         semver_version_storage *mem,
+                                         const char *buf, size_t len);
+
+/**
+ * semver_version_init_from_string_wrapped_in is
+ * semver_version_init_from_string_wrapped with trailing storage allocated from
+ * arena if given.
+ */
+semver_version_wrapped
+semver_version_init_from_string_wrapped_in(semver_arena arena,
+                                           semver_version_storage *mem,
+                                           const char *s);
+
+/**
+ * semver_version_init_from_in is semver_version_init_from with trailing
+ * storage allocated from arena if given.
+ */
+semver_version semver_version_init_from_in(semver_arena arena,
+                                           semver_version_storage *mem,
+                                           unsigned long major,
+                                           unsigned long minor,
+                                           unsigned long patch,
+                                           const char *prerelease,
+                                           const char *build);
+
+/**
+ * semver_version_init_from_copy_in is semver_version_init_from_copy with
+ * trailing storage allocated from arena if given.
+ */
+semver_version semver_version_init_from_copy_in(semver_arena arena,
+                                                semver_version_storage *mem,
+                                                const semver_version v);
+
+/**
+ * semver_version_key_exact returns 1 if versions have the same ordering key
+ * as v only if they have the same precedence, i.e. if v has no prerelease and
+ * fits the packed fields of its key; 0 otherwise.
+ */
+int semver_version_key_exact(const semver_version v);
+
+/**
+ * semver_version_hash_bytes mixes n bytes of s into hash value h, see
+ * semver_version_hash.
+ */
+unsigned long semver_version_hash_bytes(unsigned long h, const char *s,
+                                        size_t n);
+
+/**
+ * semver_version_req_bounds returns the bounds of a requirement, 0 for an
+ * unbounded side, and whether they are included.
+ */
+void semver_version_req_bounds(const semver_version_req self,
+                               semver_version *lower, int *lower_including,
+                               semver_version *upper, int *upper_including);
+
+/* flags of semver_version_req_compiled */
+#define SEMVERREQ_C_LOWER 1
+#define SEMVERREQ_C_LOWER_INCLUDING 2
+#define SEMVERREQ_C_LOWER_EXACT 4
+#define SEMVERREQ_C_UPPER 8
+#define SEMVERREQ_C_UPPER_INCLUDING 16
+#define SEMVERREQ_C_UPPER_EXACT 32
+
+/**
+ * semver_req_span is a compiled requirement prepared for branch-free
+ * matching of keys: lh/ll and uh/ul are the halves of the lower and upper
+ * bound keys, li and ui are 1 if the bounds are included, lu and uu are 1
+ * if a key tie with the bound leaves a match undecided. Unbounded sides are
+ * the lowest and highest keys, included.
+ */
+typedef struct {
+  unsigned long lh, ll, uh, ul;
+  unsigned int li, ui, lu, uu;
+} semver_req_span;
+
+/**
+ * semver_version_req_span_of prepares a compiled requirement for matching.
+ */
+void semver_version_req_span_of(const semver_version_req_compiled *c,
+                                semver_req_span *s);
+
+/**
+ * SEMVER_REQ_SPAN_MATCH matches key hi/lo against span s, setting m to 1 if
+ * it matches and und to 1 if undecided (m is meaningless then), without
+ * branches.
+ */
+#define SEMVER_REQ_SPAN_MATCH(s, hi, lo, m, und)                               \
+  do {                                                                         \
+    unsigned int eqh_ = (hi) == (s)->lh, equh_ = (hi) == (s)->uh;              \
+    unsigned int eql_ = eqh_ & ((lo) == (s)->ll);                              \
+    unsigned int equ_ = equh_ & ((lo) == (s)->ul);                             \
+    unsigned int gt_ = ((hi) > (s)->lh) | (eqh_ & ((lo) > (s)->ll));           \
+    unsigned int lt_ = ((hi) < (s)->uh) | (equh_ & ((lo) < (s)->ul));          \
+    (m) = (gt_ | (eql_ & (s)->li)) & (lt_ | (equ_ & (s)->ui));                 \
+    (und) = (eql_ & (s)->lu) | (equ_ & (s)->uu);                               \
+  } while (0)
+
+/**
+ * semver_version_req_match_block matches keys[0..n) against a requirement
+ * and its compiled form into bitmap (if given) from bit 0 of bitmap[0], see
+ * semver_version_req_matches_keys. Returns the number of matches.
+ */
+size_t semver_version_req_match_block(const semver_version_req self,
+                                      const semver_version_req_compiled *c,
+                                      const semver_version_key *keys,
+                                      const semver_version *vs, size_t n,
+                                      unsigned char *bitmap);
+
+/**
+ * semver_sort_rec is an entry being sorted: the packed ordering key of a
+ * version, and the version's index in the input.
+ */
+typedef struct {
+  semver_version_key key;
+  size_t idx;
+} semver_sort_rec;
+
+/**
+ * semver_sort_run sorts versions vs[0..n), see semversort.c. Sets *res to the
+ * resulting order, which lives in *block, to be freed by the caller. Returns
+ * the number of distinct versions if SEMVER_SORT_UNIQUE is given, n
+ * otherwise, or (size_t)-1 if out of memory.
+ */
+size_t semver_sort_run(const semver_version *vs, size_t n, int flags,
+                       unsigned int n_threads, semver_sort_rec **res,
+                       void **block);
+
+/**
+ * semver_sort_copy_in sorts versions vs[0..n) with flags, see
+ * semver_sort_run, and copies the resulting ones into arena. Sets *out and
+ * *keys to arrays, in arena, of the copies and their ordering keys, with
+ * room for one more entry. Returns their number, or (size_t)-1 if out of
+ * memory.
+ */
+size_t semver_sort_copy_in(semver_arena arena, const semver_version *vs,
+                           size_t n, int flags, semver_version **out,
+                           semver_version_key **keys);
+
+/**
+ * semver_sort_write writes all of buf to fd. Returns 0, or -1 if writing
+ * failed.
+ */
+int semver_sort_write(int fd, const char *buf, size_t n);
+
+/**
+ * semver_sort_cmp_fn compares entry i of a sequence sorted by precedence,
+ * held by ctx, to version v with ordering key k. Returns <0, 0, >0.
+ */
+typedef int (*semver_sort_cmp_fn)(const void *ctx, size_t i,
+                                  const semver_version v,
+                                  const semver_version_key *k);
+
+/**
+ * semver_sort_search_by returns the first index of n sorted entries whose
+ * version is above v if above is set, or not below v otherwise, comparing
+ * entries to v by cmp.
+ */
+size_t semver_sort_search_by(semver_sort_cmp_fn cmp, const void *ctx,
+                             size_t n, const semver_version v, int above);
+
+/**
+ * semver_sort_req_range_by sets [*begin, *end) to the indices of n sorted
+ * entries that match req, see semver_sort_search_by. Returns *end - *begin.
+ */
+size_t semver_sort_req_range_by(semver_sort_cmp_fn cmp, const void *ctx,
+                                size_t n, const semver_version_req req,
+                                size_t *begin, size_t *end);
+
+/**
+ * semver_sort_search returns the first index of sorted versions vs[0..n)
+ * whose version is above v if above is set, or not below v otherwise.
+ * Compares by keys[i] = semver_version_key_of(vs[i]) if keys is given.
+ */
+size_t semver_sort_search(const semver_version *vs,
+                          const semver_version_key *keys, size_t n,
+                          const semver_version v, int above);
+
+/**
+ * semver_sort_req_range sets [*begin, *end) to the indices of sorted
+ * versions vs[0..n) that match req, see semver_sort_search. Returns
+ * *end - *begin.
+ */
+size_t semver_sort_req_range(const semver_version *vs,
+                             const semver_version_key *keys, size_t n,
+                             const semver_version_req req, size_t *begin,
+                             size_t *end);
+
+#endif
@@ -0,0 +1,183 @@
+/*
+ * MIT License
+ *
+ * Copyright 2023 @aschmidt75
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "semver.h"
+#include "semverarena.h"
+
+/**
+ * semver_arena_block is a chunk of memory of an arena. Blocks are kept in a
+ * single linked list, newest first. Allocations are served from the bytes
+ * following the header.
+ */
+typedef struct semver_arena_block {
+  struct semver_arena_block *next;
+
+  /* number of usable bytes behind the header */
+  size_t size;
+
+  /* keeps the bytes behind the header aligned */
+  double align;
+} semver_arena_block;
+
+struct semver_arena {
+  /* allocator for blocks and the arena itself */
+  semver_allocator allocator;
+
+  /* block currently allocated from */
+  semver_arena_block *head;
+
+  /* bump pointer and end of the current block */
+  char *p;
+  char *end;
+
+  size_t block_size;
+  size_t used;
+};
+
+/* rounds n up to a multiple of SEMVER_STORAGE_ALIGN */
+#define SEMVER_ARENA_ROUND(n)                                                  \
+  (((n) + (SEMVER_STORAGE_ALIGN - 1)) & ~(size_t)(SEMVER_STORAGE_ALIGN - 1))
+
+semver_arena semver_arena_new_with(const semver_allocator *allocator,
+                                   size_t block_size) {
+  semver_allocator a;
+  struct semver_arena *res;
+
+  if (allocator) {
+    a = *allocator;
+  } else {
+    semver_get_allocator(&a);
+  }
+  res = a.malloc_fn(a.user, sizeof(struct semver_arena));
+  if (!res) {
+    return 0;
+  }
+  res->allocator = a;
+  res->head = 0;
+  res->p = 0;
+  res->end = 0;
+  res->block_size =
+      SEMVER_ARENA_ROUND(block_size ? block_size : SEMVER_ARENA_DEFAULT_BLOCK_SIZE);
+  res->used = 0;
+  return res;
+}
+
+semver_arena semver_arena_new(size_t block_size) {
+  return semver_arena_new_with(0, block_size);
+}
+
+/* allocates and frees blocks through the arena's allocator */
+#define SEMVER_ARENA_MALLOC(self, n)                                           \
+  ((self)->allocator.malloc_fn((self)->allocator.user, (n)))
+#define SEMVER_ARENA_FREE(self, p)                                             \
+  ((self)->allocator.free_fn((self)->allocator.user, (p)))
+
+/**
+ * semver_arena_grow adds a block with at least size usable bytes to the
+ * arena and makes it the current one.
+ */
+semver_arena_block *semver_arena_grow(semver_arena self, size_t size) {
+  semver_arena_block *b;
+  if (size < self->block_size) {
+    size = self->block_size;
+  }
+  b = SEMVER_ARENA_MALLOC(self, sizeof(semver_arena_block) + size);
+  if (!b) {
+    return 0;
+  }
+  b->next = self->head;
+  b->size = size;
+  self->head = b;
+  self->p = (char *)(b + 1);
+  self->end = self->p + size;
+  return b;
+}
+
+void *semver_arena_alloc(semver_arena self, size_t size) {
+  void *res;
+  /* rounding and the block header must not wrap around */
+  if (size > (size_t)-1 - SEMVER_STORAGE_ALIGN - sizeof(semver_arena_block)) {
+    return 0;
+  }
+  size = SEMVER_ARENA_ROUND(size);
+  if ((size_t)(self->end - self->p) < size || self->p == 0) {
+    if (size > self->block_size / 2 && self->head != 0) {
+      /* large allocation: give it a block of its own, but keep allocating
+       * from the current block afterwards */
+      semver_arena_block *b =
+          SEMVER_ARENA_MALLOC(self, sizeof(semver_arena_block) + size);
+      if (!b) {
+        return 0;
+      }
+      b->size = size;
+      b->next = self->head->next;
+      self->head->next = b;
+      self->used += size;
+      return (void *)(b + 1);
+    }
+    if (!semver_arena_grow(self, size)) {
+      return 0;
+    }
+  }
+  res = self->p;
+  self->p += size;
+  self->used += size;
+  return res;
+}
+
+void semver_arena_reset(semver_arena self) {
+  semver_arena_block *b, *next;
+  if (!self || !self->head) {
+    return;
+  }
+  /* keep the current block, which is always a regular one */
+  for (b = self->head->next; b; b = next) {
+    next = b->next;
+    SEMVER_ARENA_FREE(self, b);
+  }
+  self->head->next = 0;
+  self->p = (char *)(self->head + 1);
+  self->end = self->p + self->head->size;
+  self->used = 0;
+}
+
+void semver_arena_delete(semver_arena self) {
+  semver_arena_block *b, *next;
+  if (!self) {
+    return;
+  }
+  for (b = self->head; b; b = next) {
+    next = b->next;
+    SEMVER_ARENA_FREE(self, b);
+  }
+  SEMVER_ARENA_FREE(self, self);
+}
+
+size_t semver_arena_used(const semver_arena self) {
+  return self->used;
+}
@@ -0,0 +1,187 @@
+/*
+ * MIT License
+ *
+ * Copyright 2023 @aschmidt75
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "semver.h"
+#include "semverbatch.h"
+#include "semver_impl.h"
+
+/* initial capacity of the string pool, grows by doubling */
+#define SEMVER_BATCH_POOL_MIN 256
+
+/**
+ * semver_version_batch_pool_add appends a string of length n plus a
+ * terminating NUL to the pool of self. Returns its offset, or
+ * SEMVER_BATCH_NONE if out of memory.
+ */
+size_t semver_version_batch_pool_add(semver_version_batch *self,
+                                     const char *s, size_t n) {
+  size_t off = self->pool_len;
+  size_t cap;
+  char *p;
+
+  if (n >= (size_t)-1 - self->pool_len) {
+    return SEMVER_BATCH_NONE;
+  }
+  if (self->pool_len + n + 1 > self->pool_cap) {
+    cap = self->pool_cap ? self->pool_cap : SEMVER_BATCH_POOL_MIN;
+    while (cap < self->pool_len + n + 1) {
+      /* doubling would wrap around, take what is needed instead */
+      cap = cap > (size_t)-1 / 2 ? self->pool_len + n + 1 : 2 * cap;
+    }
+    p = semver_realloc(self->pool, cap);
+    if (!p) {
+      return SEMVER_BATCH_NONE;
+    }
+    self->pool = p;
+    self->pool_cap = cap;
+  }
+  memcpy(self->pool + off, s, n);
+  self->pool[off + n] = '\0';
+  self->pool_len += n + 1;
+
+  return off;
+}
+
+int semver_version_batch_parse(semver_version_batch *batch,
+                               const char *const *strs, const size_t *lens,
+                               size_t n) {
+  const size_t row_size =
+      3 * sizeof(unsigned long) + 2 * sizeof(size_t) + sizeof(int);
+  semver_version_view v;
+  size_t i;
+  char *block;
+  int k;
+
+  memset(batch, 0, sizeof(semver_version_batch));
+  if (n == 0) {
+    return SEMVER_OK;
+  }
+  if (n > (size_t)-1 / row_size) {
+    return SEMVER_ERROR_OUT_OF_MEMORY;
+  }
+
+  /* all columns live in a single block, widest types first */
+  block = semver_malloc(n * row_size);
+  if (!block) {
+    return SEMVER_ERROR_OUT_OF_MEMORY;
+  }
+  batch->n = n;
+  batch->major = (unsigned long *)block;
+  batch->minor = batch->major + n;
+  batch->patch = batch->minor + n;
+  batch->prerelease_off = (size_t *)(batch->patch + n);
+  batch->build_off = batch->prerelease_off + n;
+  batch->err = (int *)(batch->build_off + n);
+
+  for (i = 0; i < n; i++) {
+    batch->major[i] = 0;
+    batch->minor[i] = 0;
+    batch->patch[i] = 0;
+    batch->prerelease_off[i] = SEMVER_BATCH_NONE;
+    batch->build_off[i] = SEMVER_BATCH_NONE;
+
+    if (!strs[i]) {
+      batch->err[i] = SEMVER_ERROR_PARSE_PREMATURE_EOS;
+      continue;
+    }
+    k = semver_version_parse(strs[i], lens ? lens[i] : strlen(strs[i]), &v);
+    batch->err[i] = k;
+    if (k != SEMVER_OK) {
+      continue;
+    }
+    batch->major[i] = v.major;
+    batch->minor[i] = v.minor;
+    batch->patch[i] = v.patch;
+    if (v.prerelease) {
+      batch->prerelease_off[i] =
+          semver_version_batch_pool_add(batch, v.prerelease, v.prerelease_len);
+      if (batch->prerelease_off[i] == SEMVER_BATCH_NONE) {
+        goto oom;
+      }
+    }
+    if (v.build) {
+      batch->build_off[i] =
+          semver_version_batch_pool_add(batch, v.build, v.build_len);
+      if (batch->build_off[i] == SEMVER_BATCH_NONE) {
+        goto oom;
+      }
+    }
+    batch->n_ok++;
+  }
+
+  return SEMVER_OK;
+
+oom:
+  semver_version_batch_destroy(batch);
+  return SEMVER_ERROR_OUT_OF_MEMORY;
+}
+
+void semver_version_batch_destroy(semver_version_batch *batch) {
+  if (!batch) {
+    return;
+  }
+  semver_free(batch->major);
+  semver_free(batch->pool);
+  memset(batch, 0, sizeof(semver_version_batch));
+}
+
+const char *semver_version_batch_prerelease(const semver_version_batch *batch,
+                                            size_t i) {
+  if (!batch || i >= batch->n ||
+      batch->prerelease_off[i] == SEMVER_BATCH_NONE) {
+    return 0;
+  }
+  return batch->pool + batch->prerelease_off[i];
+}
+
+const char *semver_version_batch_build(const semver_version_batch *batch,
+                                       size_t i) {
+  if (!batch || i >= batch->n || batch->build_off[i] == SEMVER_BATCH_NONE) {
+    return 0;
+  }
+  return batch->pool + batch->build_off[i];
+}
+
+semver_version
+semver_version_batch_init_version(const semver_version_batch *batch, size_t i,
+                                  semver_version_storage *mem) {
+  semver_version_view v;
+
+  if (!batch || !mem || i >= batch->n || batch->err[i] != SEMVER_OK) {
+    return 0;
+  }
+  v.major = batch->major[i];
+  v.minor = batch->minor[i];
+  v.patch = batch->patch[i];
+  v.prerelease = semver_version_batch_prerelease(batch, i);
+  v.prerelease_len = v.prerelease ? strlen(v.prerelease) : 0;
+  v.n_idents = semver_version_tokenize(v.prerelease, v.prerelease_len, 0);
+  v.build = semver_version_batch_build(batch, i);
+  v.build_len = v.build ? strlen(v.build) : 0;
+
+  return semver_version_init_view_in(0, mem, &v);
+}
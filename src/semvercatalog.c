@@ -0,0 +1,123 @@
+/*
+ * MIT License
+ *
+ * Copyright 2023 @aschmidt75
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "semver.h"
+#include "semverarena.h"
+#include "semvercatalog.h"
+#include "semver_impl.h"
+
+/**
+ * semver_catalog keeps copies of its versions sorted by precedence, with
+ * their ordering keys for the binary searches. All of it lives in the
+ * catalog's arena.
+ */
+struct semver_catalog {
+  semver_arena arena;
+  semver_version *vs;
+  semver_version_key *keys;
+  size_t n;
+};
+
+semver_catalog semver_catalog_new(const semver_version *vs, size_t n) {
+  semver_catalog self;
+  semver_arena arena;
+
+  arena = semver_arena_new(0);
+  if (!arena) {
+    return 0;
+  }
+  self = semver_arena_alloc(arena, sizeof(struct semver_catalog));
+  if (!self) {
+    semver_arena_delete(arena);
+    return 0;
+  }
+  self->arena = arena;
+  self->n = semver_sort_copy_in(arena, vs, n, 0, &self->vs, &self->keys);
+  if (self->n == (size_t)-1) {
+    semver_arena_delete(arena);
+    return 0;
+  }
+  return self;
+}
+
+void semver_catalog_delete(semver_catalog self) {
+  if (self) {
+    semver_arena_delete(self->arena);
+  }
+}
+
+size_t semver_catalog_count(const semver_catalog self) {
+  return self->n;
+}
+
+semver_version semver_catalog_get(const semver_catalog self, size_t i) {
+  if (i >= self->n) {
+    return 0;
+  }
+  return self->vs[i];
+}
+
+size_t semver_catalog_req_range(const semver_catalog self,
+                                const semver_version_req req, size_t *begin,
+                                size_t *end) {
+  return semver_sort_req_range(self->vs, self->keys, self->n, req, begin,
+                               end);
+}
+
+semver_version semver_catalog_max_satisfying(const semver_catalog self,
+                                             const semver_version_req req) {
+  size_t begin, end;
+
+  if (semver_catalog_req_range(self, req, &begin, &end) == 0) {
+    return 0;
+  }
+  return self->vs[end - 1];
+}
+
+semver_version semver_catalog_min_satisfying(const semver_catalog self,
+                                             const semver_version_req req) {
+  size_t begin, end;
+
+  if (semver_catalog_req_range(self, req, &begin, &end) == 0) {
+    return 0;
+  }
+  return self->vs[begin];
+}
+
+semver_version semver_catalog_floor(const semver_catalog self,
+                                    const semver_version v) {
+  size_t i = semver_sort_search(self->vs, self->keys, self->n, v, 1);
+
+  return i > 0 ? self->vs[i - 1] : 0;
+}
+
+semver_version semver_catalog_ceiling(const semver_catalog self,
+                                      const semver_version v) {
+  size_t i = semver_sort_search(self->vs, self->keys, self->n, v, 0);
+
+  return i < self->n ? self->vs[i] : 0;
+}
@@ -0,0 +1,388 @@
+/*
+ * MIT License
+ *
+ * Copyright 2023 @aschmidt75
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/* open, fstat and mmap are POSIX */
+#define _POSIX_C_SOURCE 200809L
+#include <fcntl.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "semver.h"
+#include "semverreq.h"
+#include "semvercatfile.h"
+#include "semver_impl.h"
+
+#define SEMVER_CATFILE_MAGIC "semvcat\n"
+#define SEMVER_CATFILE_ORDER 0x01020304UL
+/* alignment of the records section */
+#define SEMVER_CATFILE_ALIGN 64
+/* string offset of absent prerelease and build parts */
+#define SEMVER_CATFILE_NONE ULONG_MAX
+
+/** semver_catfile_header is the header of a catalog file */
+typedef struct {
+  char magic[8];
+  unsigned long version;
+  unsigned long order;
+  unsigned long word_size;
+  unsigned long n;
+  /* offset of the records, and of the string pool and its length */
+  unsigned long recs;
+  unsigned long pool;
+  unsigned long pool_len;
+  /* length of the file */
+  unsigned long size;
+} semver_catfile_header;
+
+/** semver_catfile_rec is the record of a version in a catalog file */
+typedef struct {
+  semver_version_key key;
+  /* versions of equal precedence have equal ranks */
+  unsigned long rank;
+  unsigned long major;
+  unsigned long minor;
+  unsigned long patch;
+  unsigned long n_idents;
+  /* offsets into the string pool, SEMVER_CATFILE_NONE if absent */
+  unsigned long prerelease;
+  unsigned long prerelease_len;
+  unsigned long build;
+  unsigned long build_len;
+} semver_catfile_rec;
+
+struct semver_catfile {
+  void *map;
+  size_t size;
+  const semver_catfile_rec *recs;
+  const char *pool;
+  size_t n;
+};
+
+/* offset of the records section, behind the header */
+#define SEMVER_CATFILE_RECS                                                    \
+  ((sizeof(semver_catfile_header) + SEMVER_CATFILE_ALIGN - 1) /                \
+   SEMVER_CATFILE_ALIGN * SEMVER_CATFILE_ALIGN)
+
+/**
+ * semver_catfile_pool_add appends a string of length n to the pool at
+ * pool[*len], NUL-terminated. Returns its offset.
+ */
+unsigned long semver_catfile_pool_add(char *pool, size_t *len, const char *s,
+                                      size_t n) {
+  unsigned long off = (unsigned long)*len;
+
+  memcpy(pool + *len, s, n);
+  pool[*len + n] = '\0';
+  *len += n + 1;
+  return off;
+}
+
+int semver_catfile_write(int fd, const semver_version *vs, size_t n) {
+  char pad[SEMVER_CATFILE_RECS];
+  semver_catfile_header h;
+  semver_catfile_rec *recs = 0;
+  semver_sort_rec *res = 0;
+  semver_version_view view;
+  const semver_version_impl *v;
+  void *block = 0;
+  char *pool = 0;
+  size_t i, pool_len = 0, pool_cap = 0;
+  int k = SEMVER_OK;
+
+  if (n > 0 && semver_sort_run(vs, n, 0, 1, &res, &block) == (size_t)-1) {
+    return SEMVER_ERROR_OUT_OF_MEMORY;
+  }
+  for (i = 0; i < n; i++) {
+    semver_version_view_of((const semver_version_impl *)vs[i], &view);
+    pool_cap += view.prerelease_len + view.build_len + 2;
+  }
+  recs = semver_malloc(n * sizeof(semver_catfile_rec) + 1);
+  pool = semver_malloc(pool_cap + 1);
+  if (!recs || !pool) {
+    k = SEMVER_ERROR_OUT_OF_MEMORY;
+    goto out;
+  }
+
+  for (i = 0; i < n; i++) {
+    v = (const semver_version_impl *)vs[res[i].idx];
+    semver_version_view_of(v, &view);
+    recs[i].key = res[i].key;
+    recs[i].rank = i == 0 ? 0 : recs[i - 1].rank;
+    if (i > 0 && semver_version_cmp(vs[res[i - 1].idx], vs[res[i].idx]) != 0) {
+      recs[i].rank++;
+    }
+    recs[i].major = view.major;
+    recs[i].minor = view.minor;
+    recs[i].patch = view.patch;
+    recs[i].n_idents = (unsigned long)view.n_idents;
+    recs[i].prerelease = SEMVER_CATFILE_NONE;
+    recs[i].prerelease_len = 0;
+    recs[i].build = SEMVER_CATFILE_NONE;
+    recs[i].build_len = 0;
+    if (view.prerelease) {
+      recs[i].prerelease = semver_catfile_pool_add(
+          pool, &pool_len, view.prerelease, view.prerelease_len);
+      recs[i].prerelease_len = (unsigned long)view.prerelease_len;
+    }
+    if (view.build) {
+      recs[i].build =
+          semver_catfile_pool_add(pool, &pool_len, view.build, view.build_len);
+      recs[i].build_len = (unsigned long)view.build_len;
+    }
+  }
+
+  memset(&h, 0, sizeof(h));
+  memcpy(h.magic, SEMVER_CATFILE_MAGIC, sizeof(h.magic));
+  h.version = SEMVER_CATFILE_VERSION;
+  h.order = SEMVER_CATFILE_ORDER;
+  h.word_size = sizeof(unsigned long);
+  h.n = (unsigned long)n;
+  h.recs = SEMVER_CATFILE_RECS;
+  h.pool = h.recs + n * sizeof(semver_catfile_rec);
+  h.pool_len = (unsigned long)pool_len;
+  h.size = h.pool + pool_len;
+
+  memset(pad, 0, sizeof(pad));
+  memcpy(pad, &h, sizeof(h));
+  if (semver_sort_write(fd, pad, sizeof(pad)) ||
+      semver_sort_write(fd, (const char *)recs,
+                        n * sizeof(semver_catfile_rec)) ||
+      semver_sort_write(fd, pool, pool_len)) {
+    k = SEMVER_ERROR_IO;
+  }
+
+out:
+  semver_free(block);
+  semver_free(recs);
+  semver_free(pool);
+  return k;
+}
+
+/**
+ * semver_catfile_check_str checks a prerelease or build string of a record
+ * at offset off of the pool: it must be absent with length 0, or lie within
+ * the pool, be NUL-terminated and consist of identifier characters only.
+ */
+int semver_catfile_check_str(const char *pool, unsigned long pool_len,
+                             unsigned long off, unsigned long len) {
+  if (off == SEMVER_CATFILE_NONE) {
+    return len == 0;
+  }
+  return off < pool_len && len < pool_len - off && pool[off + len] == '\0' &&
+         semver_scan_span(pool + off, len, SEMVER_SCAN_IDENT, 0) == len;
+}
+
+/**
+ * semver_catfile_check checks the header and records of a mapped catalog
+ * file of given size, so that no access is out of its bounds. Records must
+ * hold strings a parsed version could hold, with as many prerelease
+ * identifiers as their strings split into, as versions are built from them
+ * in storage sized by n_idents. Returns SEMVER_OK or SEMVER_ERROR_STRUCTURE.
+ */
+int semver_catfile_check(const void *map, size_t size) {
+  const semver_catfile_header *h = map;
+  const semver_catfile_rec *r;
+  const char *pool;
+  size_t i, n_idents;
+
+  if (size < SEMVER_CATFILE_RECS ||
+      memcmp(h->magic, SEMVER_CATFILE_MAGIC, sizeof(h->magic)) != 0 ||
+      h->version != SEMVER_CATFILE_VERSION ||
+      h->order != SEMVER_CATFILE_ORDER ||
+      h->word_size != sizeof(unsigned long) || h->size != size ||
+      h->recs != SEMVER_CATFILE_RECS ||
+      h->n > (size - h->recs) / sizeof(semver_catfile_rec) ||
+      h->pool != h->recs + h->n * sizeof(semver_catfile_rec) ||
+      h->pool_len != size - h->pool) {
+    return SEMVER_ERROR_STRUCTURE;
+  }
+  r = (const semver_catfile_rec *)((const char *)map + h->recs);
+  pool = (const char *)map + h->pool;
+  for (i = 0; i < h->n; i++, r++) {
+    if (!semver_catfile_check_str(pool, h->pool_len, r->prerelease,
+                                  r->prerelease_len) ||
+        !semver_catfile_check_str(pool, h->pool_len, r->build,
+                                  r->build_len) ||
+        r->prerelease_len + r->build_len >= SEMVER_MAXLEN) {
+      return SEMVER_ERROR_STRUCTURE;
+    }
+    n_idents = r->prerelease == SEMVER_CATFILE_NONE
+                   ? 0
+                   : semver_version_tokenize(pool + r->prerelease,
+                                             r->prerelease_len, 0);
+    if (r->n_idents != n_idents) {
+      return SEMVER_ERROR_STRUCTURE;
+    }
+  }
+  return SEMVER_OK;
+}
+
+int semver_catfile_open(const char *path, semver_catfile *out) {
+  semver_catfile self;
+  struct stat st;
+  void *map;
+  int fd, k;
+
+  fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    return SEMVER_ERROR_IO;
+  }
+  if (fstat(fd, &st) != 0) {
+    close(fd);
+    return SEMVER_ERROR_IO;
+  }
+  if ((size_t)st.st_size < SEMVER_CATFILE_RECS) {
+    close(fd);
+    return SEMVER_ERROR_STRUCTURE;
+  }
+  map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED) {
+    return SEMVER_ERROR_IO;
+  }
+
+  k = semver_catfile_check(map, (size_t)st.st_size);
+  if (k == SEMVER_OK) {
+    self = semver_malloc(sizeof(struct semver_catfile));
+    if (!self) {
+      k = SEMVER_ERROR_OUT_OF_MEMORY;
+    }
+  }
+  if (k != SEMVER_OK) {
+    munmap(map, (size_t)st.st_size);
+    return k;
+  }
+  self->map = map;
+  self->size = (size_t)st.st_size;
+  self->n = ((const semver_catfile_header *)map)->n;
+  self->recs = (const semver_catfile_rec *)((const char *)map +
+                                            SEMVER_CATFILE_RECS);
+  self->pool =
+      (const char *)map + ((const semver_catfile_header *)map)->pool;
+  *out = self;
+  return SEMVER_OK;
+}
+
+void semver_catfile_close(semver_catfile self) {
+  if (self) {
+    munmap(self->map, self->size);
+    semver_free(self);
+  }
+}
+
+size_t semver_catfile_count(const semver_catfile self) {
+  return self->n;
+}
+
+unsigned long semver_catfile_major(const semver_catfile self, size_t i) {
+  return self->recs[i].major;
+}
+
+unsigned long semver_catfile_minor(const semver_catfile self, size_t i) {
+  return self->recs[i].minor;
+}
+
+unsigned long semver_catfile_patch(const semver_catfile self, size_t i) {
+  return self->recs[i].patch;
+}
+
+const char *semver_catfile_prerelease(const semver_catfile self, size_t i) {
+  const semver_catfile_rec *r = &self->recs[i];
+  return r->prerelease == SEMVER_CATFILE_NONE ? 0 : self->pool + r->prerelease;
+}
+
+const char *semver_catfile_build(const semver_catfile self, size_t i) {
+  const semver_catfile_rec *r = &self->recs[i];
+  return r->build == SEMVER_CATFILE_NONE ? 0 : self->pool + r->build;
+}
+
+int semver_catfile_cmp(const semver_catfile self, size_t i, size_t j) {
+  return (self->recs[i].rank > self->recs[j].rank) -
+         (self->recs[i].rank < self->recs[j].rank);
+}
+
+semver_version semver_catfile_get(const semver_catfile self, size_t i,
+                                  semver_version_storage *mem) {
+  const semver_catfile_rec *r = &self->recs[i];
+  semver_version_view view;
+
+  view.major = r->major;
+  view.minor = r->minor;
+  view.patch = r->patch;
+  view.prerelease = semver_catfile_prerelease(self, i);
+  view.prerelease_len = r->prerelease_len;
+  view.build = semver_catfile_build(self, i);
+  view.build_len = r->build_len;
+  view.n_idents = r->n_idents;
+  return semver_version_init_view_in(0, mem, &view);
+}
+
+/**
+ * semver_catfile_cmp_version compares the version at position i of a
+ * catalog file ctx to v with ordering key k, see semver_sort_cmp_fn. Fields
+ * are only compared if the keys are equal, without building a version from
+ * the record.
+ */
+int semver_catfile_cmp_version(const void *ctx, size_t i,
+                               const semver_version v,
+                               const semver_version_key *k) {
+  const semver_catfile self = (semver_catfile)ctx;
+  const semver_catfile_rec *r = &self->recs[i];
+  const semver_version_impl *w = (const semver_version_impl *)v;
+  semver_version_view view;
+  int c = semver_version_key_cmp(&r->key, k);
+
+  if (c != 0) {
+    return c;
+  }
+  semver_version_view_of(w, &view);
+  if (r->major != view.major) {
+    return r->major < view.major ? -1 : 1;
+  }
+  if (r->minor != view.minor) {
+    return r->minor < view.minor ? -1 : 1;
+  }
+  if (r->patch != view.patch) {
+    return r->patch < view.patch ? -1 : 1;
+  }
+  return semver_version_prerelease_cmp(semver_catfile_prerelease(self, i),
+                                       semver_version_prerelease_str(w));
+}
+
+size_t semver_catfile_lower_bound(const semver_catfile self,
+                                  const semver_version v) {
+  return semver_sort_search_by(semver_catfile_cmp_version, self, self->n, v,
+                               0);
+}
+
+size_t semver_catfile_req_range(const semver_catfile self,
+                                const semver_version_req req, size_t *begin,
+                                size_t *end) {
+  return semver_sort_req_range_by(semver_catfile_cmp_version, self, self->n,
+                                  req, begin, end);
+}
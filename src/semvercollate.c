@@ -0,0 +1,237 @@
+/*
+ * MIT License
+ *
+ * Copyright 2023 @aschmidt75
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "semver.h"
+#include "semver_impl.h"
+
+/*
+ * Layout of a collation key:
+ *
+ *   major, minor, patch   each as one length byte (number of significant
+ *                         bytes) followed by the value, big-endian
+ *   prerelease            for each identifier:
+ *                           SEMVER_COLLATE_NUMERIC, one length byte,
+ *                           digits without leading zeros
+ *                         or
+ *                           SEMVER_COLLATE_ALNUM, characters, 0x00
+ *                         then SEMVER_COLLATE_END
+ *   or release            SEMVER_COLLATE_RELEASE
+ *   build, optional       SEMVER_COLLATE_BUILD, characters
+ *
+ * Tags are ordered so that memcmp follows semver precedence: fewer
+ * identifiers sort first (END), numeric identifiers sort before
+ * alphanumeric ones, and versions without prerelease sort last (RELEASE).
+ * Identifier characters are all greater than 0x00, which terminates
+ * alphanumeric identifiers.
+ */
+#define SEMVER_COLLATE_END 0x01
+#define SEMVER_COLLATE_NUMERIC 0x02
+#define SEMVER_COLLATE_ALNUM 0x03
+#define SEMVER_COLLATE_RELEASE 0x04
+#define SEMVER_COLLATE_BUILD 0x05
+
+/* appends byte c to the key if there is space left, counts it anyway */
+#define SEMVER_COLLATE_PUT(c)                                                  \
+  do {                                                                         \
+    if (n < size) {                                                            \
+      buf[n] = (unsigned char)(c);                                             \
+    }                                                                          \
+    n++;                                                                       \
+  } while (0)
+
+size_t semver_version_collation_key(const semver_version _self, int flags,
+                                    unsigned char *buf, size_t size) {
+  const semver_version_impl *self = (semver_version_impl *)_self;
+  const semver_version_ident *ident = SEMVER_IDENTS(self);
+  const char *p;
+  unsigned long parts[3];
+  size_t n = 0;
+  size_t i, j, len;
+  int k;
+
+  parts[0] = self->major;
+  parts[1] = self->minor;
+  parts[2] = self->patch;
+  for (i = 0; i < 3; i++) {
+    for (k = 0; k < (int)sizeof(unsigned long) && (parts[i] >> (8 * k)) != 0;
+         k++) {
+    }
+    SEMVER_COLLATE_PUT(k);
+    while (k-- > 0) {
+      SEMVER_COLLATE_PUT(parts[i] >> (8 * k));
+    }
+  }
+
+  if (self->n_idents == 0) {
+    SEMVER_COLLATE_PUT(SEMVER_COLLATE_RELEASE);
+  } else {
+    p = semver_version_prerelease_str(self);
+    for (i = 0; i < self->n_idents; i++) {
+      len = ident[i].len;
+      if (ident[i].kind == SEMVER_IDENT_ALNUM) {
+        SEMVER_COLLATE_PUT(SEMVER_COLLATE_ALNUM);
+        for (j = 0; j < len; j++) {
+          SEMVER_COLLATE_PUT(p[j]);
+        }
+        SEMVER_COLLATE_PUT(0);
+      } else {
+        for (j = 0; j + 1 < len && p[j] == '0'; j++) {
+        }
+        SEMVER_COLLATE_PUT(SEMVER_COLLATE_NUMERIC);
+        SEMVER_COLLATE_PUT(len - j);
+        for (; j < len; j++) {
+          SEMVER_COLLATE_PUT(p[j]);
+        }
+      }
+      p += len + 1;
+    }
+    SEMVER_COLLATE_PUT(SEMVER_COLLATE_END);
+  }
+
+  if ((flags & SEMVER_COLLATE_WITH_BUILD) && (self->flags & SEMVER_HAS_BUILD)) {
+    SEMVER_COLLATE_PUT(SEMVER_COLLATE_BUILD);
+    p = semver_version_build_str(self);
+    for (j = 0; j < self->build_len; j++) {
+      SEMVER_COLLATE_PUT(p[j]);
+    }
+  }
+
+  return n;
+}
+
+/**
+ * semver_version_collation_num decodes a length-prefixed number at *pp.
+ * Returns 0 if malformed.
+ */
+int semver_version_collation_num(const unsigned char **pp,
+                                 const unsigned char *end,
+                                 unsigned long *out) {
+  const unsigned char *p = *pp;
+  unsigned long x = 0;
+  size_t k;
+
+  if (p == end || *p > sizeof(unsigned long) || (size_t)(end - p) <= *p) {
+    return 0;
+  }
+  k = *p++;
+  /* a minimal encoding has no leading zero bytes */
+  if (k > 0 && *p == 0) {
+    return 0;
+  }
+  while (k-- > 0) {
+    x = (x << 8) | *p++;
+  }
+  *pp = p;
+  *out = x;
+  return 1;
+}
+
+semver_version semver_version_from_collation_key(const unsigned char *buf,
+                                                 size_t len) {
+  const unsigned char *p = buf;
+  const unsigned char *end = buf + len;
+  char pre[SEMVER_MAXLEN];
+  semver_version_view v;
+  size_t n = 0;
+  size_t k;
+
+  if (!buf || !semver_version_collation_num(&p, end, &v.major) ||
+      !semver_version_collation_num(&p, end, &v.minor) ||
+      !semver_version_collation_num(&p, end, &v.patch) || p == end) {
+    return 0;
+  }
+  v.prerelease = 0;
+  v.prerelease_len = 0;
+  v.n_idents = 0;
+  v.build = 0;
+  v.build_len = 0;
+
+  if (*p == SEMVER_COLLATE_RELEASE) {
+    p++;
+  } else {
+    while (p < end && *p != SEMVER_COLLATE_END) {
+      if (n > 0) {
+        pre[n++] = '.';
+      }
+      /* each tag holds exactly one identifier: no '.' in its bytes, and
+       * its kind must match them, as the encoder produces */
+      if (*p == SEMVER_COLLATE_ALNUM) {
+        k = n;
+        for (p++; p < end && *p != 0 && *p != '.' && n < sizeof(pre); p++) {
+          pre[n++] = *p;
+        }
+        if (p == end || *p != 0 ||
+            semver_version_ident_is_numeric(pre + k, n - k)) {
+          return 0;
+        }
+        p++;
+      } else if (*p == SEMVER_COLLATE_NUMERIC && end - p > 1) {
+        k = p[1];
+        p += 2;
+        if (k == 0 || (size_t)(end - p) < k || n + k >= sizeof(pre) ||
+            (k > 1 && *p == '0') ||
+            !semver_version_ident_is_numeric((const char *)p, k)) {
+          return 0;
+        }
+        memcpy(pre + n, p, k);
+        n += k;
+        p += k;
+      } else {
+        return 0;
+      }
+      if (n >= sizeof(pre)) {
+        return 0;
+      }
+      v.n_idents++;
+    }
+    if (p == end || v.n_idents == 0) {
+      return 0;
+    }
+    p++;
+    v.prerelease = pre;
+    v.prerelease_len = n;
+  }
+
+  if (p < end) {
+    if (*p != SEMVER_COLLATE_BUILD) {
+      return 0;
+    }
+    p++;
+    v.build = (const char *)p;
+    v.build_len = end - p;
+  }
+
+  /* identifiers are validated like parsed input */
+  if (semver_scan_span(pre, n, SEMVER_SCAN_IDENT, 0) != n ||
+      semver_scan_span(v.build, v.build_len, SEMVER_SCAN_IDENT, 0) !=
+          v.build_len ||
+      n + v.build_len + 2 >= SEMVER_MAXLEN) {
+    return 0;
+  }
+
+  return semver_version_from_view_in(0, &v);
+}
@@ -0,0 +1,242 @@
+/*
+ * MIT License
+ *
+ * Copyright 2023 @aschmidt75
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "semver.h"
+#include "semverarena.h"
+#include "semverintern.h"
+#include "semver_impl.h"
+
+/* initial number of hash slots, a power of 2 */
+#define SEMVER_INTERN_MIN_SLOTS 64
+
+/**
+ * semver_intern_entry is a version of the table, indexed by its ID.
+ * Canonical version and string live in the table's arena.
+ */
+typedef struct {
+  semver_version v;
+  const char *str;
+  size_t len;
+  unsigned long hash;
+} semver_intern_entry;
+
+/**
+ * semver_intern is an open-addressing hash table (linear probing) of IDs,
+ * keyed by the canonical strings of their versions.
+ */
+struct semver_intern {
+  semver_arena arena;
+  semver_intern_entry *entries;
+  size_t n;
+  size_t cap;
+  /* ID + 1 of each slot, 0 for empty slots */
+  unsigned long *slots;
+  size_t n_slots;
+};
+
+semver_intern semver_intern_new(void) {
+  semver_intern self = semver_malloc(sizeof(struct semver_intern));
+  if (!self) {
+    return 0;
+  }
+  self->arena = semver_arena_new(0);
+  self->slots = semver_malloc(SEMVER_INTERN_MIN_SLOTS * sizeof(unsigned long));
+  if (!self->arena || !self->slots) {
+    semver_arena_delete(self->arena);
+    semver_free(self->slots);
+    semver_free(self);
+    return 0;
+  }
+  memset(self->slots, 0, SEMVER_INTERN_MIN_SLOTS * sizeof(unsigned long));
+  self->n_slots = SEMVER_INTERN_MIN_SLOTS;
+  self->entries = 0;
+  self->n = 0;
+  self->cap = 0;
+  return self;
+}
+
+void semver_intern_delete(semver_intern self) {
+  if (!self) {
+    return;
+  }
+  semver_arena_delete(self->arena);
+  semver_free(self->entries);
+  semver_free(self->slots);
+  semver_free(self);
+}
+
+/**
+ * semver_intern_slot returns the slot of a string: the one holding its ID,
+ * or the empty one it would be inserted into.
+ */
+size_t semver_intern_slot(const semver_intern self, const char *buf,
+                          size_t len, unsigned long hash) {
+  size_t mask = self->n_slots - 1;
+  size_t i = hash & mask;
+  const semver_intern_entry *e;
+
+  while (self->slots[i]) {
+    e = &self->entries[self->slots[i] - 1];
+    if (e->hash == hash && e->len == len && memcmp(e->str, buf, len) == 0) {
+      break;
+    }
+    i = (i + 1) & mask;
+  }
+  return i;
+}
+
+/**
+ * semver_intern_grow doubles the number of slots. Returns 0 if out of memory.
+ */
+int semver_intern_grow(semver_intern self) {
+  unsigned long *old = self->slots;
+  size_t n_old = self->n_slots;
+  size_t i, j, mask;
+
+  self->slots = semver_malloc(2 * n_old * sizeof(unsigned long));
+  if (!self->slots) {
+    self->slots = old;
+    return 0;
+  }
+  memset(self->slots, 0, 2 * n_old * sizeof(unsigned long));
+  self->n_slots = 2 * n_old;
+  mask = self->n_slots - 1;
+  for (i = 0; i < n_old; i++) {
+    if (old[i]) {
+      j = self->entries[old[i] - 1].hash & mask;
+      while (self->slots[j]) {
+        j = (j + 1) & mask;
+      }
+      self->slots[j] = old[i];
+    }
+  }
+  semver_free(old);
+  return 1;
+}
+
+int semver_intern_find(const semver_intern self, const char *buf, size_t len,
+                       unsigned long *id) {
+  unsigned long hash = semver_version_hash_bytes(0, buf, len);
+  size_t i = semver_intern_slot(self, buf, len, hash);
+
+  if (!self->slots[i]) {
+    return 0;
+  }
+  *id = self->slots[i] - 1;
+  return 1;
+}
+
+int semver_intern_strn(semver_intern self, const char *buf, size_t len,
+                       unsigned long *id) {
+  unsigned long hash = semver_version_hash_bytes(0, buf, len);
+  size_t i = semver_intern_slot(self, buf, len, hash);
+  semver_version_wrapped w;
+  semver_intern_entry *e;
+  char *str;
+
+  if (self->slots[i]) {
+    *id = self->slots[i] - 1;
+    return SEMVER_OK;
+  }
+
+  /* not seen before: parse, which validates the string */
+  if (self->n == SEMVER_INTERN_MAX) {
+    return SEMVER_ERROR_OUT_OF_MEMORY;
+  }
+  /* keep the load factor at 1/2 at most, growing before inserting so that
+   * the table never fills up if growing fails */
+  if (2 * (self->n + 1) > self->n_slots) {
+    if (!semver_intern_grow(self)) {
+      return SEMVER_ERROR_OUT_OF_MEMORY;
+    }
+    i = semver_intern_slot(self, buf, len, hash);
+  }
+  if (self->n == self->cap) {
+    e = semver_realloc(self->entries,
+                       (2 * self->cap + 16) * sizeof(semver_intern_entry));
+    if (!e) {
+      return SEMVER_ERROR_OUT_OF_MEMORY;
+    }
+    self->entries = e;
+    self->cap = 2 * self->cap + 16;
+  }
+  w = semver_version_from_strn_wrapped_in(self->arena, buf, len);
+  if (w.err) {
+    return w.unwrap.code;
+  }
+  str = semver_arena_alloc(self->arena, len + 1);
+  if (!str) {
+    return SEMVER_ERROR_OUT_OF_MEMORY;
+  }
+  memcpy(str, buf, len);
+  str[len] = '\0';
+
+  e = &self->entries[self->n];
+  e->v = w.unwrap.result;
+  e->str = str;
+  e->len = len;
+  e->hash = hash;
+  self->slots[i] = ++self->n;
+  *id = self->n - 1;
+  return SEMVER_OK;
+}
+
+int semver_intern_string(semver_intern self, const char *s,
+                         unsigned long *id) {
+  if (!s) {
+    return SEMVER_ERROR_PARSE_PREMATURE_EOS;
+  }
+  return semver_intern_strn(self, s, strlen(s), id);
+}
+
+int semver_intern_version(semver_intern self, const semver_version v,
+                          unsigned long *id) {
+  char buf[SEMVER_MAXLEN + 1];
+  size_t n;
+
+  /* the canonical string of a version is how it prints */
+  n = semver_version_sprint(v, buf);
+  return semver_intern_strn(self, buf, n, id);
+}
+
+semver_version semver_intern_get(const semver_intern self, unsigned long id) {
+  if (id >= self->n) {
+    return 0;
+  }
+  return self->entries[id].v;
+}
+
+const char *semver_intern_str(const semver_intern self, unsigned long id) {
+  if (id >= self->n) {
+    return 0;
+  }
+  return self->entries[id].str;
+}
+
+size_t semver_intern_count(const semver_intern self) {
+  return self->n;
+}
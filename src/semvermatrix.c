@@ -0,0 +1,234 @@
+/*
+ * MIT License
+ *
+ * Copyright 2023 @aschmidt75
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "semver.h"
+#include "semverreq.h"
+#include "semvermatrix.h"
+#include "semver_impl.h"
+
+/* keys compared at a time per requirement, a multiple of 8. Key halves of
+ * a tile take 8 KB on 64-bit targets and stay in L1 cache while all
+ * requirements are matched against them. */
+#define SEMVER_MATRIX_TILE 512
+
+/*
+ * The vector path compares 4 keys at a time. It needs 64-bit keys, see
+ * semverscan.c for how vector paths are selected.
+ */
+#if !defined(SEMVER_NO_SIMD) && defined(__GNUC__) && defined(__AVX2__) &&     \
+    ULONG_MAX > 0xffffffffUL
+#define SEMVER_MATRIX_AVX2
+#include <immintrin.h>
+#endif
+
+/* number of bits set in each byte value */
+static const unsigned char semver_matrix_popcount8[256] = {
+#define SEMVER_MATRIX_P2(n) n, n + 1, n + 1, n + 2
+#define SEMVER_MATRIX_P4(n)                                                    \
+  SEMVER_MATRIX_P2(n), SEMVER_MATRIX_P2(n + 1), SEMVER_MATRIX_P2(n + 1),       \
+      SEMVER_MATRIX_P2(n + 2)
+#define SEMVER_MATRIX_P6(n)                                                    \
+  SEMVER_MATRIX_P4(n), SEMVER_MATRIX_P4(n + 1), SEMVER_MATRIX_P4(n + 1),       \
+      SEMVER_MATRIX_P4(n + 2)
+    SEMVER_MATRIX_P6(0), SEMVER_MATRIX_P6(1), SEMVER_MATRIX_P6(1),
+    SEMVER_MATRIX_P6(2)};
+
+/**
+ * semver_matrix_block_scalar matches the keys hi/lo[i..n) against span s,
+ * into out from byte i / 8; i is a multiple of 8. Sets *any_und if any
+ * match is undecided. Returns the number of (decided) matches.
+ */
+size_t semver_matrix_block_scalar(const semver_req_span *s,
+                                  const unsigned long *hi,
+                                  const unsigned long *lo, size_t i, size_t n,
+                                  unsigned char *out, unsigned int *any_und) {
+  unsigned int m, und, b, u;
+  size_t j, e, cnt = 0;
+
+  for (; i < n; i += 8) {
+    /* a fixed trip count for full bytes lets compilers unroll */
+    e = n - i < 8 ? n - i : 8;
+    b = 0;
+    u = 0;
+    if (e == 8) {
+      for (j = 0; j < 8; j++) {
+        SEMVER_REQ_SPAN_MATCH(s, hi[i + j], lo[i + j], m, und);
+        b |= m << j;
+        u |= und << j;
+      }
+    } else {
+      for (j = 0; j < e; j++) {
+        SEMVER_REQ_SPAN_MATCH(s, hi[i + j], lo[i + j], m, und);
+        b |= m << j;
+        u |= und << j;
+      }
+    }
+    b &= ~u;
+    *any_und |= u;
+    out[i / 8] = (unsigned char)b;
+    cnt += semver_matrix_popcount8[b];
+  }
+  return cnt;
+}
+
+#if defined(SEMVER_MATRIX_AVX2)
+
+/* broadcasts an unsigned long, with its sign bit flipped: AVX2 compares
+ * signed 64-bit integers only */
+#define SEMVER_MATRIX_SET1(x)                                                  \
+  _mm256_xor_si256(_mm256_set1_epi64x((long)(x)), sign)
+
+/**
+ * semver_matrix_block_avx2 is semver_matrix_block_scalar for i == 0 and n a
+ * multiple of 8.
+ */
+size_t semver_matrix_block_avx2(const semver_req_span *s,
+                                const unsigned long *hi,
+                                const unsigned long *lo, size_t n,
+                                unsigned char *out, unsigned int *any_und) {
+  const __m256i sign = _mm256_slli_epi64(_mm256_set1_epi64x(1), 63);
+  const __m256i lh = SEMVER_MATRIX_SET1(s->lh), ll = SEMVER_MATRIX_SET1(s->ll);
+  const __m256i uh = SEMVER_MATRIX_SET1(s->uh), ul = SEMVER_MATRIX_SET1(s->ul);
+  const __m256i li = _mm256_set1_epi64x(-(long)s->li);
+  const __m256i ui = _mm256_set1_epi64x(-(long)s->ui);
+  const __m256i lu = _mm256_set1_epi64x(-(long)s->lu);
+  const __m256i uu = _mm256_set1_epi64x(-(long)s->uu);
+  __m256i h, l, eqh, equh, eql, equ, gt, lt, m, und;
+  unsigned int b, ub = 0;
+  size_t i, j, cnt = 0;
+
+  for (i = 0; i < n; i += 8) {
+    b = 0;
+    for (j = 0; j < 8; j += 4) {
+      h = _mm256_xor_si256(
+          _mm256_loadu_si256((const __m256i *)(hi + i + j)), sign);
+      l = _mm256_xor_si256(
+          _mm256_loadu_si256((const __m256i *)(lo + i + j)), sign);
+      eqh = _mm256_cmpeq_epi64(h, lh);
+      equh = _mm256_cmpeq_epi64(h, uh);
+      eql = _mm256_and_si256(eqh, _mm256_cmpeq_epi64(l, ll));
+      equ = _mm256_and_si256(equh, _mm256_cmpeq_epi64(l, ul));
+      gt = _mm256_or_si256(_mm256_cmpgt_epi64(h, lh),
+                           _mm256_and_si256(eqh, _mm256_cmpgt_epi64(l, ll)));
+      lt = _mm256_or_si256(_mm256_cmpgt_epi64(uh, h),
+                           _mm256_and_si256(equh, _mm256_cmpgt_epi64(ul, l)));
+      m = _mm256_and_si256(
+          _mm256_or_si256(gt, _mm256_and_si256(eql, li)),
+          _mm256_or_si256(lt, _mm256_and_si256(equ, ui)));
+      und = _mm256_or_si256(_mm256_and_si256(eql, lu),
+                            _mm256_and_si256(equ, uu));
+      b |= (unsigned int)_mm256_movemask_pd(
+               _mm256_castsi256_pd(_mm256_andnot_si256(und, m)))
+           << j;
+      ub |= (unsigned int)_mm256_movemask_pd(_mm256_castsi256_pd(und));
+    }
+    out[i / 8] = (unsigned char)b;
+    cnt += __builtin_popcount(b);
+  }
+  *any_und |= ub != 0;
+  return cnt;
+}
+
+#endif
+
+/**
+ * semver_matrix_block matches the keys hi/lo[0..n) of versions vs against
+ * requirement req, prepared as span s, into out. Returns the number of
+ * matches.
+ */
+size_t semver_matrix_block(const semver_version_req req,
+                           const semver_req_span *s, const unsigned long *hi,
+                           const unsigned long *lo, const semver_version *vs,
+                           size_t n, unsigned char *out) {
+  unsigned int m, und, any_und = 0;
+  size_t i = 0, cnt = 0;
+
+#if defined(SEMVER_MATRIX_AVX2)
+  i = n & ~(size_t)7;
+  cnt = semver_matrix_block_avx2(s, hi, lo, i, out, &any_und);
+#endif
+  cnt += semver_matrix_block_scalar(s, hi, lo, i, n, out, &any_und);
+  if (!any_und) {
+    return cnt;
+  }
+
+  /* ties with bounds that have a prerelease need the versions */
+  for (i = 0; i < n; i++) {
+    SEMVER_REQ_SPAN_MATCH(s, hi[i], lo[i], m, und);
+    if (und && semver_version_req_matches(req, vs[i])) {
+      out[i / 8] |= (unsigned char)(1U << (i % 8));
+      cnt++;
+    }
+  }
+  return cnt;
+}
+
+int semver_version_req_match_matrix(const semver_version_req *reqs, size_t m,
+                                    const semver_version *vs, size_t n,
+                                    unsigned char *bitmap, size_t *counts) {
+  unsigned long hi[SEMVER_MATRIX_TILE], lo[SEMVER_MATRIX_TILE];
+  size_t row = SEMVERREQ_BITMAP_SIZE(n);
+  semver_version_req_compiled c;
+  semver_version_key k;
+  semver_req_span *spans;
+  size_t r, i, j, t, cnt;
+
+  if (counts) {
+    memset(counts, 0, m * sizeof(size_t));
+  }
+  if (m == 0) {
+    return SEMVER_OK;
+  }
+  spans = semver_malloc(m * sizeof(semver_req_span));
+  if (!spans) {
+    return SEMVER_ERROR_OUT_OF_MEMORY;
+  }
+  for (r = 0; r < m; r++) {
+    semver_version_req_compile(reqs[r], &c);
+    semver_version_req_span_of(&c, &spans[r]);
+  }
+
+  for (i = 0; i < n; i += t) {
+    t = n - i < SEMVER_MATRIX_TILE ? n - i : SEMVER_MATRIX_TILE;
+    for (j = 0; j < t; j++) {
+      k = semver_version_key_of(vs[i + j]);
+      hi[j] = k.hi;
+      lo[j] = k.lo;
+    }
+    for (r = 0; r < m; r++) {
+      cnt = semver_matrix_block(reqs[r], &spans[r], hi, lo, vs + i, t,
+                                bitmap + r * row + i / 8);
+      if (counts) {
+        counts[r] += cnt;
+      }
+    }
+  }
+
+  semver_free(spans);
+  return SEMVER_OK;
+}
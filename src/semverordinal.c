@@ -0,0 +1,136 @@
+/*
+ * MIT License
+ *
+ * Copyright 2023 @aschmidt75
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "semver.h"
+#include "semverarena.h"
+#include "semverordinal.h"
+#include "semversort.h"
+#include "semver_impl.h"
+
+/**
+ * semver_ordinal keeps one version per rank, with its ordering key, and a
+ * hash table of ranks (open addressing, linear probing) over
+ * semver_version_hash. All of it lives in the map's arena.
+ */
+struct semver_ordinal {
+  semver_arena arena;
+  semver_version *reps;
+  semver_version_key *keys;
+  size_t n;
+  /* rank + 1 of each slot, 0 for empty slots */
+  size_t *slots;
+  size_t mask;
+};
+
+semver_ordinal semver_ordinal_new(const semver_version *vs, size_t n) {
+  semver_ordinal self;
+  semver_arena arena;
+  size_t u, i, j, n_slots;
+
+  arena = semver_arena_new(0);
+  if (!arena) {
+    return 0;
+  }
+  self = semver_arena_alloc(arena, sizeof(struct semver_ordinal));
+  if (!self) {
+    goto fail;
+  }
+  self->arena = arena;
+  u = semver_sort_copy_in(arena, vs, n, SEMVER_SORT_UNIQUE, &self->reps,
+                          &self->keys);
+  if (u == (size_t)-1) {
+    goto fail;
+  }
+  self->n = u;
+
+  /* at most half of the slots are used */
+  for (n_slots = 16; n_slots < 2 * u; n_slots *= 2)
+    ;
+  self->mask = n_slots - 1;
+  self->slots = semver_arena_alloc(arena, n_slots * sizeof(size_t));
+  if (!self->slots) {
+    goto fail;
+  }
+  memset(self->slots, 0, n_slots * sizeof(size_t));
+  for (i = 0; i < u; i++) {
+    j = semver_version_hash(self->reps[i]) & self->mask;
+    while (self->slots[j]) {
+      j = (j + 1) & self->mask;
+    }
+    self->slots[j] = i + 1;
+  }
+  return self;
+
+fail:
+  semver_arena_delete(arena);
+  return 0;
+}
+
+void semver_ordinal_delete(semver_ordinal self) {
+  if (self) {
+    semver_arena_delete(self->arena);
+  }
+}
+
+size_t semver_ordinal_count(const semver_ordinal self) {
+  return self->n;
+}
+
+int semver_ordinal_rank(const semver_ordinal self, const semver_version v,
+                        size_t *rank) {
+  semver_version_key k = semver_version_key_of(v);
+  size_t j = semver_version_hash(v) & self->mask;
+  size_t r;
+
+  for (; self->slots[j]; j = (j + 1) & self->mask) {
+    r = self->slots[j] - 1;
+    if (semver_version_cmp_keyed(self->reps[r], &self->keys[r], v, &k) == 0) {
+      *rank = r;
+      return 1;
+    }
+  }
+  return 0;
+}
+
+size_t semver_ordinal_lower_bound(const semver_ordinal self,
+                                  const semver_version v) {
+  return semver_sort_search(self->reps, self->keys, self->n, v, 0);
+}
+
+semver_version semver_ordinal_get(const semver_ordinal self, size_t rank) {
+  if (rank >= self->n) {
+    return 0;
+  }
+  return self->reps[rank];
+}
+
+size_t semver_ordinal_req_range(const semver_ordinal self,
+                                const semver_version_req req, size_t *begin,
+                                size_t *end) {
+  return semver_sort_req_range(self->reps, self->keys, self->n, req, begin,
+                               end);
+}
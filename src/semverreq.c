@@ -22,15 +22,19 @@
  * SOFTWARE.
  */
 
+#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <assert.h>
 
 #include "semver.h"
 #include "semverreq.h"
+#include "semverarena.h"
+#include "semver_impl.h"
 
 int semver_matches(const char *version_str, const char *versionreq_str, int *res) {
+  semver_version_req_storage r_mem;
+  semver_version_storage v_mem;
   semver_version_req r = 0;
   semver_version v = 0;
   int err = 1;
@@ -39,12 +43,12 @@ int semver_matches(const char *version_str, const char *versionreq_str, int *res
     goto end_delete;
   }
 
-  v = semver_version_from_string(version_str);
+  v = semver_version_init_from_string(&v_mem, version_str);
   if (!v) {
     goto end_delete;
   }
 
-  r = semver_version_req_from_string(versionreq_str);
+  r = semver_version_req_init_from_string(&r_mem, versionreq_str);
   if (!r) {
     goto end_delete;
   }
@@ -54,24 +58,14 @@ int semver_matches(const char *version_str, const char *versionreq_str, int *res
 
 end_delete:
   if(v) {
-    semver_version_delete(v);
+    semver_version_destroy(v);
   }
   if(r) {
-    semver_version_req_delete(r);
+    semver_version_req_destroy(r);
   }
   return err;
 }
 
-#define SEMVERREQ_NEW(obj, type)                                               \
-  do {                                                                         \
-    obj = malloc(sizeof(type));                                                \
-    if (!obj) {                                                                \
-      printf("Malloc Error\n");                                                \
-      assert(0);                                                               \
-    }                                                                          \
-  } while (0);
-
-
 /**
  * The implementation of a semver requirement consist of a lower
  * and an upper bound. Flags indicate if the bound is including (e.g. >=)
@@ -82,17 +76,41 @@ end_delete:
  * An all-matching requirement can be expressed by ">=0.0.0" and upper = null.
  * This structure does not support tilde and caret operators, these are
  * converted through the parsing process before.
+ * Both bounds are kept inline in semver_version_storage, so a requirement is
+ * a single block. Use SEMVERREQ_LOWER/SEMVERREQ_UPPER to access them.
  */
 struct semver_version_req_impl {
-  semver_version lower;
+  semver_version_storage lower_mem;
+  int has_lower;
   int lower_including;
 
-  semver_version upper;
+  semver_version_storage upper_mem;
+  int has_upper;
   int upper_including;
 
+  /* one of SEMVERREQ_STORAGE_* */
+  int storage;
 };
 typedef struct semver_version_req_impl *semver_version_req_impl;
 
+/* caller-provided storage must be able to hold a requirement */
+typedef char semver_version_req_storage_size_check
+    [(sizeof(struct semver_version_req_impl) <= SEMVERREQ_STORAGE_SIZE) ? 1
+                                                                        : -1];
+
+/* requirement has been allocated from the heap */
+#define SEMVERREQ_STORAGE_HEAP 0
+/* requirement lives in caller-provided storage */
+#define SEMVERREQ_STORAGE_CALLER 1
+/* requirement has been allocated from an arena */
+#define SEMVERREQ_STORAGE_ARENA 2
+
+/* lower and upper bound of a requirement, 0 if unbounded */
+#define SEMVERREQ_LOWER(self)                                                  \
+  ((self)->has_lower ? (semver_version)&(self)->lower_mem : 0)
+#define SEMVERREQ_UPPER(self)                                                  \
+  ((self)->has_upper ? (semver_version)&(self)->upper_mem : 0)
+
 const char *semverreq_valid_comparators[] = {
     "=", "<", ">", "<=", ">=", "^", "~"};
 
@@ -119,10 +137,31 @@ int semverreq_comparator_is_including(const char *p) {
   return 0;
 }
 
-semver_version_req semver_version_req_from(semver_version lower_bound,
-                                            int lower_including,
-                                            semver_version upper_bound,
-                                            int upper_including) {
+/**
+ * semver_version_req_take moves lower and upper bound into the requirement.
+ * Both must be 0 or point to the start of a semver_version_storage, which
+ * must not be used or destroyed afterwards.
+ */
+void semver_version_req_take(semver_version_req_impl self,
+                             semver_version lower, int lower_including,
+                             semver_version upper, int upper_including) {
+  self->has_lower = (lower != 0);
+  self->lower_including = lower_including;
+  if (lower) {
+    memcpy(&self->lower_mem, lower, sizeof(semver_version_storage));
+  }
+  self->has_upper = (upper != 0);
+  self->upper_including = upper_including;
+  if (upper) {
+    memcpy(&self->upper_mem, upper, sizeof(semver_version_storage));
+  }
+}
+
+semver_version_req semver_version_req_from_in(semver_arena arena,
+                                              semver_version lower_bound,
+                                              int lower_including,
+                                              semver_version upper_bound,
+                                              int upper_including) {
 
   semver_version_req_impl res = 0;
 
@@ -142,29 +181,62 @@ semver_version_req semver_version_req_from(semver_version lower_bound,
     }
   }
 
-  SEMVERREQ_NEW(res, struct semver_version_req_impl);
-  res->lower = 0;
-  res->upper = 0;
+  res = semver_alloc_in(arena, sizeof(struct semver_version_req_impl));
+  if (!res) {
+    return 0;
+  }
+  res->storage = arena ? SEMVERREQ_STORAGE_ARENA : SEMVERREQ_STORAGE_HEAP;
 
   /* deep-copy */
-  res->lower = (semver_version)semver_version_from_copy(lower_bound);
+  res->has_lower = (semver_version_init_from_copy_in(arena, &res->lower_mem,
+                                                     lower_bound) != 0);
   res->lower_including = lower_including;
 
-  res->upper = (semver_version)semver_version_from_copy(upper_bound);
+  res->has_upper = (semver_version_init_from_copy_in(arena, &res->upper_mem,
+                                                     upper_bound) != 0);
   res->upper_including = upper_including;
 
+  if ((lower_bound && !res->has_lower) || (upper_bound && !res->has_upper)) {
+    /* out of memory */
+    semver_version_req_delete((semver_version_req)res);
+    return 0;
+  }
+
   return (semver_version_req )res;
 }
 
+semver_version_req semver_version_req_from(semver_version lower_bound,
+                                            int lower_including,
+                                            semver_version upper_bound,
+                                            int upper_including) {
+  return semver_version_req_from_in(0, lower_bound, lower_including,
+                                    upper_bound, upper_including);
+}
+
+void semver_version_req_destroy(semver_version_req _self) {
+  semver_version_req_impl self = (semver_version_req_impl )_self;
+  if (!self) {
+    return;
+  }
+  if(self->has_lower) {
+    semver_version_destroy(SEMVERREQ_LOWER(self));
+    self->has_lower = 0;
+  }
+  if(self->has_upper) {
+    semver_version_destroy(SEMVERREQ_UPPER(self));
+    self->has_upper = 0;
+  }
+}
+
 void semver_version_req_delete(semver_version_req _self) {
-  semver_version_req_impl self = (semver_version_req )_self;
-  if(self->lower) {
-    semver_version_delete(self->lower);
+  semver_version_req_impl self = (semver_version_req_impl )_self;
+  if (!self) {
+    return;
   }
-  if(self->upper) {
-    semver_version_delete(self->upper);
+  semver_version_req_destroy(_self);
+  if (self->storage == SEMVERREQ_STORAGE_HEAP) {
+    semver_free(self);
   }
-  free(self);
 }
 
 #define _REQ_PARSER_MAX_COMP_SIZE 4
@@ -177,17 +249,20 @@ typedef struct {
   int found_semver_parts;
 } _req_parser_result_t;
 
-#define SEMVER_VALID_CHAR(c)                                                   \
-  ((((c) >= '0') && ((c) <= '9')) || (((c) >= 'a') && ((c) <= 'z')) ||         \
-   (((c) >= 'A') && ((c) <= 'Z')) || ((c) == '.') || ((c) == '+') ||           \
-   ((c) == '-'))
 #define SEMVER_VALID_FIRST_CHAR(c) (((c) >= '0') && ((c) <= '9'))
 
-void parse_version_req(const char *s, _req_parser_result_t *res) {
+/**
+ * parse_version_req_into parses a single requirement part (comparator and
+ * version). The version is placed in mem if given, allocated otherwise.
+ * Trailing storage of the version is allocated from arena if given.
+ * Input ends at end, the version is parsed in place without copying.
+ */
+void parse_version_req_into(const char *s, const char *end,
+                            _req_parser_result_t *res,
+                            semver_version_storage *mem, semver_arena arena) {
   char *c = 0;
   size_t cc = 0;
-  char scratch[SEMVER_MAXLEN];
-  char *scratchp = &scratch[0];
+  const char *start;
   semver_version_wrapped w;
 
   res->l = 0;
@@ -197,9 +272,7 @@ void parse_version_req(const char *s, _req_parser_result_t *res) {
   memset(res->comparator_buf, 0, sizeof(res->comparator_buf));
   c = &res->comparator_buf[0];
 
-  memset(scratch, 0, sizeof(scratch));
-
-  while (s && *s) {
+  while (s && s < end) {
     res->last = s;
     if ((*s == ' ') || (*s == '\t')) {
       /* skip ws */
@@ -222,17 +295,20 @@ void parse_version_req(const char *s, _req_parser_result_t *res) {
     };
     if (SEMVER_VALID_FIRST_CHAR(*s)) {
 
-      /* semver_version starts here, take everything from it into buffer */
-      while (s && *s && SEMVER_VALID_CHAR(*s)) {
-        *scratchp++ = *s++;
-      };
+      /* semver_version starts here, find its end */
+      start = s;
+      s += semver_scan_span(s, end - s, SEMVER_SCAN_VERSION, 0);
       res->last = s;
       res->found_semver_parts = 1;
-      *scratchp = '\0';
 
       res->l = 0;
       /* try to parse what we have up until now */
-      w = semver_version_from_string_wrapped(scratch);
+      if (mem) {
+        w = semver_version_init_from_strn_wrapped_in(arena, mem, start,
+                                                     s - start);
+      } else {
+        w = semver_version_from_strn_wrapped(start, s - start);
+      }
       if (w.err) {
         /* some error occured */
         break;
@@ -252,73 +328,56 @@ void parse_version_req(const char *s, _req_parser_result_t *res) {
   res->comparator_valid = semverreq_valid_comparator(res->comparator_buf);
 }
 
-semver_version_req semver_version_req_from_string(const char *str) {
-  semver_version_req_wrapped res;
-
-  if (str == 0 || strlen(str) == 0) {
-    return 0;
-  }
-
-  res = semver_version_req_from_string_wrapped(str);
-  if (res.err) {
-    return 0;
-  }
-  return res.unwrap.result;
+void parse_version_req(const char *s, _req_parser_result_t *res) {
+  parse_version_req_into(s, s ? s + strlen(s) : 0, res, 0, 0);
 }
 
-semver_version_req_wrapped
-semver_version_req_from_string_wrapped(const char *str) {
-
-  char *p = 0;
+/**
+ * semver_version_req_parse parses the first len bytes of str into self.
+ * Returns SEMVERREQ_OK or an error code, self is not initialized then.
+ * Trailing storage of the bounds is allocated from arena if given.
+ */
+int semver_version_req_parse(semver_version_req_impl self, const char *str,
+                             size_t len, semver_arena arena) {
+  const char *p = 0;
+  const char *end = str + len;
   int st = 0;
-  semver_version_req_impl res = 0;
   _req_parser_result_t part1, part2;
-  semver_version_req_wrapped w;
+  semver_version_storage mem1, mem2, mem3;
+  semver_version lower = 0;
+  semver_version upper = 0;
+  int lower_including = 0;
+  int upper_including = 0;
   int swap_flags[2] = { 0, 0 };
   int special_op = 0;
   unsigned long ma = 0;
   unsigned long mi = 0;
   unsigned long pa = 0;
-  w.err = 0;
 
   memset(part1.comparator_buf,0,sizeof(part1.comparator_buf));
   part1.last = 0; part1.l = 0;
   memset(part2.comparator_buf,0,sizeof(part2.comparator_buf));
   part2.last = 0; part2.l = 0;
 
-  if (str == 0 || strlen(str) == 0) {
-    semver_version_req_wrapped err;
-    err.err = 1;
-    err.unwrap.code = SEMVERREQ_EOI;
-    return err;
+  if (str == 0 || len == 0) {
+    return SEMVERREQ_EOI;
   }
 
-  res = (semver_version_req_impl )malloc(sizeof(struct semver_version_req_impl));
-  res->upper = 0;
-  res->lower = 0;
-
-  parse_version_req(str, &part1);
+  parse_version_req_into(str, end, &part1, &mem1, arena);
 
   if (part1.l == 0) {
     /* first part not parsed successful */
-    semver_version_req_wrapped err;
-    err.err = 1;
-    err.unwrap.code = SEMVERREQ_INVALID_SEMVER;
-    free(res);
-    return err;
+    return SEMVERREQ_INVALID_SEMVER;
   }
   if (!part1.comparator_valid) {
-    semver_version_req_wrapped err;
-    err.err = 1;
-    err.unwrap.code = SEMVERREQ_INVALID_COMPARATOR;
-    free(res);
-    return err;
+    semver_version_destroy(part1.l);
+    return SEMVERREQ_INVALID_COMPARATOR;
   }
 
   /* TODO check for 1 or 2 parts, apply rules */
   /* do we have chars left other than whitespaces? */
-  p = (char*)part1.last;
-  while (p && *p) {
+  p = part1.last;
+  while (p && p < end) {
     if( *p == ' ' || *p == '\t') {
       /* ws */
     } else {
@@ -329,8 +388,8 @@ semver_version_req_from_string_wrapped(const char *str) {
     p++;
   }
 
-  res->lower = part1.l;
-  res->lower_including =
+  lower = part1.l;
+  lower_including =
       semverreq_comparator_is_including(part1.comparator_buf);
 
   /* handle case exact match (e.g. =1.0.0). Then set upper bound accordingly
@@ -338,14 +397,18 @@ semver_version_req_from_string_wrapped(const char *str) {
    * As this is an exact version req, we can stop parsing here.
    */
   if(strcmp(part1.comparator_buf, "=") == 0) {
-    res->upper = semver_version_from_copy(res->lower);
-    res->upper_including = 1;
+    upper = semver_version_init_from_copy_in(arena, &mem3, lower);
+    upper_including = 1;
+    if (!upper) {
+      semver_version_destroy(lower);
+      return SEMVERREQ_OUT_OF_MEMORY;
+    }
     goto fin;
   }
 
   if (!st) {
     /* rest of the input was empty or whitespaces, so we have only the first part */
-    res->upper = 0;
+    upper = 0;
 
     /* treat caret and tilde operator here */
     if (strcmp(part1.comparator_buf, "~") == 0) {
@@ -354,11 +417,11 @@ semver_version_req_from_string_wrapped(const char *str) {
       set upper part, e.g.
       ~1.3.5 to < 1.4.0
       */
-      res->upper_including = 0;
+      upper_including = 0;
       ma = semver_version_get_major(part1.l);
       mi = semver_version_get_minor(part1.l);
 
-      res->upper = semver_version_from(ma, mi+1, 0, 0, 0);
+      upper = semver_version_init_from_in(arena, &mem3, ma, mi+1, 0, 0, 0);
       special_op = 1;
     }
     if (strcmp(part1.comparator_buf, "^") == 0) {
@@ -369,15 +432,15 @@ semver_version_req_from_string_wrapped(const char *str) {
         pa = semver_version_get_patch(part1.l);
 
         /* no flexibility: only the exact version will match */
-        res->upper_including = res->lower_including = 1;
+        upper_including = lower_including = 1;
 
-        res->upper = semver_version_from(0, 0, pa, 0, 0);
+        upper = semver_version_init_from_in(arena, &mem3, 0, 0, pa, 0, 0);
         special_op = 1;
       } else {
         if (ma == 0 && mi >= 1) {
           /* major zero, increase minor */
-          res->upper_including = 0;
-          res->upper = semver_version_from(ma, mi+1, 0, 0, 0);
+          upper_including = 0;
+          upper = semver_version_init_from_in(arena, &mem3, ma, mi+1, 0, 0, 0);
           special_op = 1;
         } else {
           /*
@@ -386,8 +449,8 @@ semver_version_req_from_string_wrapped(const char *str) {
            ~1.3.5 to < 2.0.0
            ~3.3 to < 4.0.0
            */
-          res->upper_including = 0;
-          res->upper = semver_version_from(ma+1, 0, 0, 0, 0);
+          upper_including = 0;
+          upper = semver_version_init_from_in(arena, &mem3, ma+1, 0, 0, 0, 0);
           special_op = 1;
 
         }
@@ -397,31 +460,22 @@ semver_version_req_from_string_wrapped(const char *str) {
   } else {
     /** Only look at the rest if no special operator (tilde, caret) has been processed */
     if (special_op == 0) {
-      parse_version_req(part1.last, &part2);
+      parse_version_req_into(part1.last, end, &part2, &mem2, arena);
 
       if (part2.l == 0) {
-        semver_version_req_wrapped err;
-        err.err = 1;
-        err.unwrap.code = SEMVERREQ_INVALID_SEMVER;
-
-        /* 2nd part not parsed successful, check why */
-        free(res);
-        free(part1.l);
-        return err;
+        /* 2nd part not parsed successful */
+        semver_version_destroy(part1.l);
+        return SEMVERREQ_INVALID_SEMVER;
       }
       if (!part2.comparator_valid) {
-        semver_version_req_wrapped err;
-        err.err = 1;
-        err.unwrap.code = SEMVERREQ_INVALID_COMPARATOR;
-
-        free(res);
-        free(part1.l);
-        return err;
+        semver_version_destroy(part1.l);
+        semver_version_destroy(part2.l);
+        return SEMVERREQ_INVALID_COMPARATOR;
       }
 
       /* for now assume part1 == lower, part== upper. */
-      res->upper = part2.l;
-      res->upper_including =
+      upper = part2.l;
+      upper_including =
           semverreq_comparator_is_including(part2.comparator_buf);
     }
 
@@ -432,8 +486,8 @@ semver_version_req_from_string_wrapped(const char *str) {
    * lower is actually an upper bound (<, <=). If so, swap the two
    * so that lower is always <= upper
    */
-  if ( res->upper && res->lower) {
-    if (res->upper) {
+  if ( upper && lower) {
+    if (upper) {
       if (
           strcmp(part2.comparator_buf, ">") == 0 ||
           strcmp(part2.comparator_buf, ">=") == 0
@@ -441,7 +495,7 @@ semver_version_req_from_string_wrapped(const char *str) {
         swap_flags[1] = 1;
       }
     }
-    if (res->lower) {
+    if (lower) {
       if (
           strcmp(part1.comparator_buf, "<") == 0 ||
           strcmp(part1.comparator_buf, "<=") == 0
@@ -450,34 +504,185 @@ semver_version_req_from_string_wrapped(const char *str) {
       }
     }
     if (swap_flags[0]+swap_flags[1] > 0) {
-      semver_version swap_version = res->upper;
-      int swap_inc = res->upper_including;
+      semver_version swap_version = upper;
+      int swap_inc = upper_including;
 
-      res->upper = res->lower;
-      res->upper_including = res->lower_including;
+      upper = lower;
+      upper_including = lower_including;
 
-      res->lower = swap_version;
-      res->lower_including = swap_inc;
+      lower = swap_version;
+      lower_including = swap_inc;
     }
   } else {
     /** if we have only a lower bound, check if this is actually an upper bound */
-    if ( !res->upper && res->lower) {
+    if ( !upper && lower) {
       if (
           strcmp(part1.comparator_buf, "<") == 0 ||
           strcmp(part1.comparator_buf, "<=") == 0
           ) {
-        res->upper = res->lower;
-        res->upper_including = res->lower_including;
+        upper = lower;
+        upper_including = lower_including;
 
-        res->lower = 0;
-        res->lower_including = 0;
+        lower = 0;
+        lower_including = 0;
       }
     }
 
   }
 
 fin:
-  w.unwrap.result = res;
+  semver_version_req_take(self, lower, lower_including, upper,
+                          upper_including);
+
+  return SEMVERREQ_OK;
+}
+
+semver_version_req semver_version_req_from_strn_in(semver_arena arena,
+                                                   const char *buf,
+                                                   size_t len) {
+  semver_version_req_wrapped res;
+
+  res = semver_version_req_from_strn_wrapped_in(arena, buf, len);
+  if (res.err) {
+    return 0;
+  }
+  return res.unwrap.result;
+}
+
+semver_version_req semver_version_req_from_strn(const char *buf, size_t len) {
+  return semver_version_req_from_strn_in(0, buf, len);
+}
+
+semver_version_req_wrapped semver_version_req_from_strn_wrapped(const char *buf,
+                                                                size_t len) {
+  return semver_version_req_from_strn_wrapped_in(0, buf, len);
+}
+
+semver_version_req semver_version_req_from_string_in(semver_arena arena,
+                                                     const char *str) {
+  if (str == 0) {
+    return 0;
+  }
+  return semver_version_req_from_strn_in(arena, str, strlen(str));
+}
+
+semver_version_req semver_version_req_from_string(const char *str) {
+  return semver_version_req_from_string_in(0, str);
+}
+
+semver_version_req_wrapped
+semver_version_req_from_string_wrapped(const char *str) {
+  return semver_version_req_from_string_wrapped_in(0, str);
+}
+
+semver_version_req_wrapped
+semver_version_req_from_string_wrapped_in(semver_arena arena, const char *str) {
+  return semver_version_req_from_strn_wrapped_in(arena, str,
+                                                 str ? strlen(str) : 0);
+}
+
+semver_version_req_wrapped
+semver_version_req_from_strn_wrapped_in(semver_arena arena, const char *buf,
+                                        size_t len) {
+  semver_version_req_impl res = 0;
+  semver_version_req_wrapped w;
+  int k;
+
+  w.err = 0;
+  if (buf == 0 || len == 0) {
+    w.err = 1;
+    w.unwrap.code = SEMVERREQ_EOI;
+    return w;
+  }
+
+  if (arena) {
+    /* parse into a temporary first, so that the requirement itself is only
+     * taken from the arena for valid input. Spilled bounds parsed before an
+     * error stay in the arena until it is reset. */
+    semver_version_req_storage tmp;
+    k = semver_version_req_parse((semver_version_req_impl)&tmp, buf, len,
+                                 arena);
+    if (k == SEMVERREQ_OK) {
+      res = semver_arena_alloc(arena, sizeof(struct semver_version_req_impl));
+      if (!res) {
+        k = SEMVERREQ_OUT_OF_MEMORY;
+      } else {
+        memcpy(res, &tmp, sizeof(struct semver_version_req_impl));
+        res->storage = SEMVERREQ_STORAGE_ARENA;
+      }
+    }
+  } else {
+    res = semver_malloc(sizeof(struct semver_version_req_impl));
+    if (!res) {
+      k = SEMVERREQ_OUT_OF_MEMORY;
+    } else {
+      res->storage = SEMVERREQ_STORAGE_HEAP;
+      k = semver_version_req_parse(res, buf, len, 0);
+      if (k != SEMVERREQ_OK) {
+        semver_free(res);
+      }
+    }
+  }
+  if (k != SEMVERREQ_OK) {
+    w.err = 1;
+    w.unwrap.code = k;
+    return w;
+  }
+  w.unwrap.result = (semver_version_req)res;
+
+  return w;
+}
+
+semver_version_req
+semver_version_req_init_from_strn(semver_version_req_storage *mem,
+                                  const char *buf, size_t len) {
+  semver_version_req_wrapped res;
+
+  res = semver_version_req_init_from_strn_wrapped(mem, buf, len);
+  if (res.err) {
+    return 0;
+  }
+  return res.unwrap.result;
+}
+
+semver_version_req
+semver_version_req_init_from_string(semver_version_req_storage *mem,
+                                    const char *str) {
+  if (str == 0) {
+    return 0;
+  }
+  return semver_version_req_init_from_strn(mem, str, strlen(str));
+}
+
+semver_version_req_wrapped
+semver_version_req_init_from_string_wrapped(semver_version_req_storage *mem,
+                                            const char *str) {
+  return semver_version_req_init_from_strn_wrapped(mem, str,
+                                                   str ? strlen(str) : 0);
+}
+
+semver_version_req_wrapped
+semver_version_req_init_from_strn_wrapped(semver_version_req_storage *mem,
+                                          const char *buf, size_t len) {
+  semver_version_req_impl res = (semver_version_req_impl)mem;
+  semver_version_req_wrapped w;
+  int k;
+
+  w.err = 0;
+  if (mem == 0) {
+    w.err = 1;
+    w.unwrap.code = SEMVERREQ_EOI;
+    return w;
+  }
+
+  res->storage = SEMVERREQ_STORAGE_CALLER;
+  k = semver_version_req_parse(res, buf, len, 0);
+  if (k != SEMVERREQ_OK) {
+    w.err = 1;
+    w.unwrap.code = k;
+    return w;
+  }
+  w.unwrap.result = (semver_version_req)res;
 
   return w;
 }
@@ -486,6 +691,7 @@ fin:
 int semver_version_req_snprint(semver_version_req _self, char *buf,
                                size_t sz) {
   semver_version_req_impl self = (semver_version_req_impl )_self;
+  semver_version lower, upper;
   char lower_cmp[8] = "\0\0\0";
   char upper_cmp[8] = "\0\0\0";
   char buf1[SEMVER_MAXLEN];
@@ -496,6 +702,8 @@ int semver_version_req_snprint(semver_version_req _self, char *buf,
   if (buf == 0 || sz == 0) {
     return 0;
   }
+  lower = SEMVERREQ_LOWER(self);
+  upper = SEMVERREQ_UPPER(self);
   if (self->lower_including == 0) {
     strcpy(lower_cmp, ">");
   } else {
@@ -507,29 +715,29 @@ int semver_version_req_snprint(semver_version_req _self, char *buf,
     strcpy(upper_cmp, "<=");
   }
 
-  if (self->lower == NULL && self->upper == NULL) {
+  if (lower == NULL && upper == NULL) {
     *buf = 0; /* no info yields empty string */
     return 0;
   }
-  if (self->lower != NULL && self->upper == NULL) {
-    k = semver_version_snprint(self->lower, buf1, sizeof(buf1));
+  if (lower != NULL && upper == NULL) {
+    k = semver_version_snprint(lower, buf1, sizeof(buf1));
     return snprintf(buf, sz, "%s%s", lower_cmp, buf1);
   }
-  if (self->upper != NULL && self->lower == NULL) {
-    semver_version_snprint(self->upper, buf1, sizeof(buf1));
+  if (upper != NULL && lower == NULL) {
+    semver_version_snprint(upper, buf1, sizeof(buf1));
     return snprintf(buf, sz, "%s%s", upper_cmp, buf1);
   }
 
 
   /* now if *lower == *upper, then we can simplify the output */
-  c = semver_version_cmp(self->lower, self->upper);
+  c = semver_version_cmp(lower, upper);
   if (c == 0 && self->lower_including == 1 && self->upper_including == 1) {
-    semver_version_snprint(self->lower, buf1, sizeof(buf1));
+    semver_version_snprint(lower, buf1, sizeof(buf1));
     return snprintf(buf, sz, "=%s", buf1);
   }
 
-  semver_version_snprint(self->lower, buf1, sizeof(buf1));
-  semver_version_snprint(self->upper, buf2, sizeof(buf2));
+  semver_version_snprint(lower, buf1, sizeof(buf1));
+  semver_version_snprint(upper, buf2, sizeof(buf2));
 
   return snprintf(buf, sz, "%s%s %s%s", lower_cmp, buf1, upper_cmp, buf2);
 }
@@ -538,6 +746,7 @@ int semver_version_req_snprint(semver_version_req _self, char *buf,
 
 int semver_version_req_sprint(semver_version_req _self, char *buf) {
   semver_version_req_impl self = (semver_version_req_impl )_self;
+  semver_version lower, upper;
   char lower_cmp[8] = "\0\0\0";
   char upper_cmp[8] = "\0\0\0";
   char buf1[SEMVER_MAXLEN] = "\0";
@@ -548,6 +757,8 @@ int semver_version_req_sprint(semver_version_req _self, char *buf) {
   if (buf == 0 || self == 0) {
     return 0;
   }
+  lower = SEMVERREQ_LOWER(self);
+  upper = SEMVERREQ_UPPER(self);
   if (self->lower_including == 0) {
     strcpy(lower_cmp, ">");
   } else {
@@ -560,24 +771,24 @@ int semver_version_req_sprint(semver_version_req _self, char *buf) {
   }
 
 
-  if (self->lower == 0 && self->upper == 0) {
+  if (lower == 0 && upper == 0) {
     buf[0] = 0; /* no info yields empty string */
     return 0;
   }
-  if (self->lower != 0 && self->upper == 0) {
-    semver_version_sprint(self->lower, buf1);
+  if (lower != 0 && upper == 0) {
+    semver_version_sprint(lower, buf1);
     return sprintf(buf, "%s%s", lower_cmp, buf1);
   }
-  if (self->upper != 0 && self->lower == 0) {
-    semver_version_sprint(self->upper, buf1);
+  if (upper != 0 && lower == 0) {
+    semver_version_sprint(upper, buf1);
     return sprintf(buf, "%s%s", upper_cmp, buf1);
   }
 
-  semver_version_sprint(self->lower, buf1);
-  semver_version_sprint(self->upper, buf2);
+  semver_version_sprint(lower, buf1);
+  semver_version_sprint(upper, buf2);
 
   /* now if *lower == *upper, then we can simplify the output */
-  c = semver_version_cmp(self->lower, self->upper);
+  c = semver_version_cmp(lower, upper);
 
   if (c == 0 && self->lower_including == 1 && self->upper_including == 1) {
     return sprintf(buf, "=%s", buf1);
@@ -591,18 +802,215 @@ int semver_version_req_matches(semver_version_req _self, semver_version v) {
 
   semver_version_req_impl self = (semver_version_req_impl)_self;
 
-  cl = semver_version_cmp(v, self->lower);
-  if (cl < 0 || (cl == 0 && !self->lower_including)) {
-    return 0;
-    /* v is not compatible with lower bound */
+  if (self->has_lower) {
+    cl = semver_version_cmp(v, SEMVERREQ_LOWER(self));
+    if (cl < 0 || (cl == 0 && !self->lower_including)) {
+      return 0;
+      /* v is not compatible with lower bound */
+    }
   }
 
-  cu = semver_version_cmp(v, self->upper);
-  if (cu > 0 || (cu == 0 && !self->upper_including)) {
-    return 0;
-    /* v is not compatible with upper bound */
+  if (self->has_upper) {
+    cu = semver_version_cmp(v, SEMVERREQ_UPPER(self));
+    if (cu > 0 || (cu == 0 && !self->upper_including)) {
+      return 0;
+      /* v is not compatible with upper bound */
+    }
   }
 
   /* v is compatible with both lower and upper bound */
   return 1;
 }
+
+void semver_version_req_bounds(const semver_version_req _self,
+                               semver_version *lower, int *lower_including,
+                               semver_version *upper, int *upper_including) {
+  semver_version_req_impl self = (semver_version_req_impl)_self;
+
+  *lower = SEMVERREQ_LOWER(self);
+  *lower_including = self->lower_including;
+  *upper = SEMVERREQ_UPPER(self);
+  *upper_including = self->upper_including;
+}
+
+/* a compiled requirement fits a cache line of 64 bytes */
+typedef char semver_version_req_compiled_size_check
+    [(sizeof(semver_version_req_compiled) <= 64) ? 1 : -1];
+
+void semver_version_req_compile(const semver_version_req _self,
+                                semver_version_req_compiled *out) {
+  semver_version_req_impl self = (semver_version_req_impl)_self;
+
+  memset(out, 0, sizeof(*out));
+  if (self->has_lower) {
+    out->lower = semver_version_key_of(SEMVERREQ_LOWER(self));
+    out->flags |= SEMVERREQ_C_LOWER;
+    if (self->lower_including) {
+      out->flags |= SEMVERREQ_C_LOWER_INCLUDING;
+    }
+    if (semver_version_key_exact(SEMVERREQ_LOWER(self))) {
+      out->flags |= SEMVERREQ_C_LOWER_EXACT;
+    }
+  }
+  if (self->has_upper) {
+    out->upper = semver_version_key_of(SEMVERREQ_UPPER(self));
+    out->flags |= SEMVERREQ_C_UPPER;
+    if (self->upper_including) {
+      out->flags |= SEMVERREQ_C_UPPER_INCLUDING;
+    }
+    if (semver_version_key_exact(SEMVERREQ_UPPER(self))) {
+      out->flags |= SEMVERREQ_C_UPPER_EXACT;
+    }
+  }
+}
+
+int semver_version_req_compiled_match_key(const semver_version_req_compiled *c,
+                                          const semver_version_key *k) {
+  int undecided = 0, r;
+
+  if (c->flags & SEMVERREQ_C_LOWER) {
+    r = semver_version_key_cmp(k, &c->lower);
+    if (r < 0) {
+      return 0;
+    }
+    if (r == 0) {
+      /* equal keys of an exact bound mean equal versions */
+      if (!(c->flags & SEMVERREQ_C_LOWER_EXACT)) {
+        undecided = 1;
+      } else if (!(c->flags & SEMVERREQ_C_LOWER_INCLUDING)) {
+        return 0;
+      }
+    }
+  }
+  if (c->flags & SEMVERREQ_C_UPPER) {
+    r = semver_version_key_cmp(k, &c->upper);
+    if (r > 0) {
+      return 0;
+    }
+    if (r == 0) {
+      if (!(c->flags & SEMVERREQ_C_UPPER_EXACT)) {
+        undecided = 1;
+      } else if (!(c->flags & SEMVERREQ_C_UPPER_INCLUDING)) {
+        return 0;
+      }
+    }
+  }
+  return undecided ? SEMVERREQ_UNDECIDED : 1;
+}
+
+int semver_version_req_compiled_matches(const semver_version_req_compiled *c,
+                                        const semver_version_req self,
+                                        const semver_version v) {
+  semver_version_key k = semver_version_key_of(v);
+  int r = semver_version_req_compiled_match_key(c, &k);
+
+  if (r == SEMVERREQ_UNDECIDED) {
+    return semver_version_req_matches(self, v);
+  }
+  return r;
+}
+
+/* number of keys computed at a time by semver_version_req_matches_many, a
+ * multiple of 8 */
+#define SEMVERREQ_MATCH_CHUNK 256
+
+void semver_version_req_span_of(const semver_version_req_compiled *c,
+                                 semver_req_span *s) {
+  /* an unbounded side compares to the lowest or highest key, included */
+  s->lh = 0;
+  s->ll = 0;
+  s->li = 1;
+  s->lu = 0;
+  s->uh = ULONG_MAX;
+  s->ul = ULONG_MAX;
+  s->ui = 1;
+  s->uu = 0;
+  if (c->flags & SEMVERREQ_C_LOWER) {
+    s->lh = c->lower.hi;
+    s->ll = c->lower.lo;
+    s->li = (c->flags & SEMVERREQ_C_LOWER_INCLUDING) != 0;
+    s->lu = (c->flags & SEMVERREQ_C_LOWER_EXACT) == 0;
+  }
+  if (c->flags & SEMVERREQ_C_UPPER) {
+    s->uh = c->upper.hi;
+    s->ul = c->upper.lo;
+    s->ui = (c->flags & SEMVERREQ_C_UPPER_INCLUDING) != 0;
+    s->uu = (c->flags & SEMVERREQ_C_UPPER_EXACT) == 0;
+  }
+}
+
+/**
+ * semver_version_req_match_block matches keys[0..n) against compiled
+ * requirement c, into bitmap bytes starting at bit 0 of bitmap[0] if
+ * given. Versions whose keys tie with an inexact bound are matched in a
+ * second pass against self. The first pass is free of branches, so that
+ * compilers may vectorize it. Returns the number of matches.
+ */
+size_t semver_version_req_match_block(const semver_version_req self,
+                                      const semver_version_req_compiled *c,
+                                      const semver_version_key *keys,
+                                      const semver_version *vs, size_t n,
+                                      unsigned char *bitmap) {
+  semver_req_span s;
+  unsigned int m, und, any_und = 0;
+  unsigned int b;
+  size_t i, j, cnt = 0;
+
+  semver_version_req_span_of(c, &s);
+  for (i = 0; i < n; i += 8) {
+    b = 0;
+    for (j = 0; j < 8 && i + j < n; j++) {
+      SEMVER_REQ_SPAN_MATCH(&s, keys[i + j].hi, keys[i + j].lo, m, und);
+      any_und |= und;
+      b |= (m & !und) << j;
+      cnt += m & !und;
+    }
+    if (bitmap) {
+      bitmap[i / 8] = (unsigned char)b;
+    }
+  }
+  if (!any_und) {
+    return cnt;
+  }
+
+  for (i = 0; i < n; i++) {
+    if (semver_version_req_compiled_match_key(c, &keys[i]) ==
+            SEMVERREQ_UNDECIDED &&
+        semver_version_req_matches(self, vs[i])) {
+      cnt++;
+      if (bitmap) {
+        bitmap[i / 8] |= (unsigned char)(1U << (i % 8));
+      }
+    }
+  }
+  return cnt;
+}
+
+size_t semver_version_req_matches_keys(const semver_version_req self,
+                                       const semver_version_key *keys,
+                                       const semver_version *vs, size_t n,
+                                       unsigned char *bitmap) {
+  semver_version_req_compiled c;
+
+  semver_version_req_compile(self, &c);
+  return semver_version_req_match_block(self, &c, keys, vs, n, bitmap);
+}
+
+size_t semver_version_req_matches_many(const semver_version_req self,
+                                       const semver_version *vs, size_t n,
+                                       unsigned char *bitmap) {
+  semver_version_key keys[SEMVERREQ_MATCH_CHUNK];
+  semver_version_req_compiled c;
+  size_t i, j, m, cnt = 0;
+
+  semver_version_req_compile(self, &c);
+  for (i = 0; i < n; i += m) {
+    m = n - i < SEMVERREQ_MATCH_CHUNK ? n - i : SEMVERREQ_MATCH_CHUNK;
+    for (j = 0; j < m; j++) {
+      keys[j] = semver_version_key_of(vs[i + j]);
+    }
+    cnt += semver_version_req_match_block(self, &c, keys, vs + i, m,
+                                          bitmap ? bitmap + i / 8 : 0);
+  }
+  return cnt;
+}
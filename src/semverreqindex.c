@@ -0,0 +1,595 @@
+/*
+ * MIT License
+ *
+ * Copyright 2023 @aschmidt75
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "semver.h"
+#include "semverreq.h"
+#include "semverreqindex.h"
+#include "semver_impl.h"
+
+/*
+ * Bounds are points of an extended order of versions: for each version v
+ * there are points just below v, at v, and just above v, so that an
+ * exclusive lower bound ">v" is the point just above v, and an exclusive
+ * upper bound "<v" the one just below v. A requirement is then the closed
+ * interval [L, U] of its bound points, and matches v if L <= v <= U.
+ */
+#define SEMVER_RI_NEG_INF (-2)
+#define SEMVER_RI_BELOW (-1)
+#define SEMVER_RI_AT 0
+#define SEMVER_RI_ABOVE 1
+#define SEMVER_RI_POS_INF 2
+
+/* maximum depth of the tree, see semver_req_index_limit */
+#define SEMVER_RI_MAX_DEPTH 128
+
+/** semver_ri_point is a point of the extended order */
+typedef struct {
+  semver_version v;
+  semver_version_key k;
+  /* one of SEMVER_RI_*, v is unused for infinite points */
+  int side;
+} semver_ri_point;
+
+/** semver_ri_entry is an indexed requirement */
+typedef struct {
+  semver_version_req req;
+  semver_ri_point lower;
+  semver_ri_point upper;
+} semver_ri_entry;
+
+/**
+ * semver_ri_node is a node of the interval tree. It holds the entries whose
+ * intervals contain its center, sorted by lower bounds ascending and by
+ * upper bounds descending. Entries of the left subtree lie below the center,
+ * the ones of the right subtree above.
+ */
+typedef struct semver_ri_node {
+  /* owns a copy of its version, requirements may be removed and freed */
+  semver_ri_point center;
+  struct semver_ri_node *left;
+  struct semver_ri_node *right;
+  /* number of entries in the subtree, including this node */
+  size_t weight;
+  semver_ri_entry **by_lower;
+  semver_ri_entry **by_upper;
+  size_t n;
+  size_t cap;
+} semver_ri_node;
+
+struct semver_req_index {
+  semver_ri_node *root;
+  /* entries with empty intervals, which no version matches */
+  semver_ri_entry **empty;
+  size_t n_empty;
+  size_t cap_empty;
+  /* number of entries, and the maximum since the last full rebuild */
+  size_t n;
+  size_t max_n;
+};
+
+int semver_ri_point_cmp(const semver_ri_point *a, const semver_ri_point *b) {
+  int c;
+
+  if (a->side == SEMVER_RI_NEG_INF || a->side == SEMVER_RI_POS_INF ||
+      b->side == SEMVER_RI_NEG_INF || b->side == SEMVER_RI_POS_INF) {
+    if (a->side == b->side) {
+      return 0;
+    }
+    return (a->side == SEMVER_RI_NEG_INF || b->side == SEMVER_RI_POS_INF) ? -1
+                                                                         : 1;
+  }
+  c = semver_version_cmp_keyed(a->v, &a->k, b->v, &b->k);
+  if (c != 0) {
+    return c < 0 ? -1 : 1;
+  }
+  return (a->side > b->side) - (a->side < b->side);
+}
+
+/**
+ * semver_ri_point_of sets p to the point of bound v, 0 if unbounded: side
+ * if v is included, off otherwise; inf if unbounded.
+ */
+void semver_ri_point_of(semver_ri_point *p, semver_version v, int including,
+                        int off, int inf) {
+  if (!v) {
+    p->v = 0;
+    p->side = inf;
+    return;
+  }
+  p->v = v;
+  p->k = semver_version_key_of(v);
+  p->side = including ? SEMVER_RI_AT : off;
+}
+
+void semver_ri_entry_of(semver_ri_entry *e, semver_version_req req) {
+  semver_version lower, upper;
+  int lower_including, upper_including;
+
+  semver_version_req_bounds(req, &lower, &lower_including, &upper,
+                            &upper_including);
+  e->req = req;
+  semver_ri_point_of(&e->lower, lower, lower_including, SEMVER_RI_ABOVE,
+                     SEMVER_RI_NEG_INF);
+  semver_ri_point_of(&e->upper, upper, upper_including, SEMVER_RI_BELOW,
+                     SEMVER_RI_POS_INF);
+}
+
+int semver_ri_lower_qsort_cmp(const void *a, const void *b) {
+  return semver_ri_point_cmp(&(*(semver_ri_entry *const *)a)->lower,
+                             &(*(semver_ri_entry *const *)b)->lower);
+}
+
+int semver_ri_upper_qsort_cmp(const void *a, const void *b) {
+  return semver_ri_point_cmp(&(*(semver_ri_entry *const *)b)->upper,
+                             &(*(semver_ri_entry *const *)a)->upper);
+}
+
+int semver_ri_point_qsort_cmp(const void *a, const void *b) {
+  return semver_ri_point_cmp(*(const semver_ri_point *const *)a,
+                             *(const semver_ri_point *const *)b);
+}
+
+semver_req_index semver_req_index_new(void) {
+  semver_req_index self = semver_malloc(sizeof(struct semver_req_index));
+  if (!self) {
+    return 0;
+  }
+  memset(self, 0, sizeof(struct semver_req_index));
+  return self;
+}
+
+/**
+ * semver_ri_free_tree frees the nodes of a subtree, and their entries if
+ * entries is set.
+ */
+void semver_ri_free_tree(semver_ri_node *node, int entries) {
+  size_t i;
+
+  while (node) {
+    semver_ri_node *right = node->right;
+    semver_ri_free_tree(node->left, entries);
+    for (i = 0; entries && i < node->n; i++) {
+      semver_free(node->by_lower[i]);
+    }
+    if (node->center.v) {
+      semver_version_delete(node->center.v);
+    }
+    semver_free(node->by_lower);
+    semver_free(node->by_upper);
+    semver_free(node);
+    node = right;
+  }
+}
+
+void semver_req_index_delete(semver_req_index self) {
+  size_t i;
+
+  if (!self) {
+    return;
+  }
+  semver_ri_free_tree(self->root, 1);
+  for (i = 0; i < self->n_empty; i++) {
+    semver_free(self->empty[i]);
+  }
+  semver_free(self->empty);
+  semver_free(self);
+}
+
+size_t semver_req_index_count(const semver_req_index self) {
+  return self->n;
+}
+
+/**
+ * semver_ri_node_new creates a node of given center, with room for cap
+ * entries. Returns 0 if out of memory.
+ */
+semver_ri_node *semver_ri_node_new(const semver_ri_point *center, size_t cap) {
+  semver_ri_node *node = semver_malloc(sizeof(semver_ri_node));
+
+  if (!node) {
+    return 0;
+  }
+  memset(node, 0, sizeof(semver_ri_node));
+  node->center = *center;
+  if (center->v) {
+    node->center.v = semver_version_from_copy(center->v);
+  }
+  node->cap = cap < 4 ? 4 : cap;
+  node->by_lower = semver_malloc(node->cap * sizeof(semver_ri_entry *));
+  node->by_upper = semver_malloc(node->cap * sizeof(semver_ri_entry *));
+  if (!node->by_lower || !node->by_upper || (center->v && !node->center.v)) {
+    semver_ri_free_tree(node, 0);
+    return 0;
+  }
+  return node;
+}
+
+/**
+ * semver_ri_node_add adds an entry to a node, keeping the sort orders.
+ * Returns 0 if out of memory.
+ */
+int semver_ri_node_add(semver_ri_node *node, semver_ri_entry *e) {
+  semver_ri_entry **p;
+  size_t lo, hi, mid;
+
+  if (node->n == node->cap) {
+    p = semver_realloc(node->by_lower, 2 * node->cap * sizeof(*p));
+    if (!p) {
+      return 0;
+    }
+    node->by_lower = p;
+    p = semver_realloc(node->by_upper, 2 * node->cap * sizeof(*p));
+    if (!p) {
+      return 0;
+    }
+    node->by_upper = p;
+    node->cap *= 2;
+  }
+
+  /* behind the entries of equal bounds */
+  for (lo = 0, hi = node->n; lo < hi;) {
+    mid = lo + (hi - lo) / 2;
+    if (semver_ri_point_cmp(&node->by_lower[mid]->lower, &e->lower) <= 0) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  memmove(node->by_lower + lo + 1, node->by_lower + lo,
+          (node->n - lo) * sizeof(*p));
+  node->by_lower[lo] = e;
+
+  for (lo = 0, hi = node->n; lo < hi;) {
+    mid = lo + (hi - lo) / 2;
+    if (semver_ri_point_cmp(&node->by_upper[mid]->upper, &e->upper) >= 0) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  memmove(node->by_upper + lo + 1, node->by_upper + lo,
+          (node->n - lo) * sizeof(*p));
+  node->by_upper[lo] = e;
+
+  node->n++;
+  return 1;
+}
+
+/**
+ * semver_ri_node_take removes the entry of req from a node, and returns it;
+ * 0 if not found.
+ */
+semver_ri_entry *semver_ri_node_take(semver_ri_node *node,
+                                     semver_version_req req) {
+  semver_ri_entry *e = 0;
+  size_t i, j;
+
+  for (i = 0; i < node->n && node->by_lower[i]->req != req; i++)
+    ;
+  if (i == node->n) {
+    return 0;
+  }
+  e = node->by_lower[i];
+  memmove(node->by_lower + i, node->by_lower + i + 1,
+          (node->n - i - 1) * sizeof(e));
+  for (j = 0; node->by_upper[j] != e; j++)
+    ;
+  memmove(node->by_upper + j, node->by_upper + j + 1,
+          (node->n - j - 1) * sizeof(e));
+  node->n--;
+  return e;
+}
+
+/**
+ * semver_ri_collect appends the entries of a subtree to out.
+ */
+void semver_ri_collect(const semver_ri_node *node, semver_ri_entry **out,
+                       size_t *n) {
+  while (node) {
+    memcpy(out + *n, node->by_lower, node->n * sizeof(semver_ri_entry *));
+    *n += node->n;
+    semver_ri_collect(node->left, out, n);
+    node = node->right;
+  }
+}
+
+/**
+ * semver_ri_build builds a balanced subtree of n entries, which are
+ * reordered. The center of each node is the median of the bound points of
+ * its subtree, so at most half of the entries go to either side. Returns 0
+ * if n is 0, and sets *err if out of memory.
+ */
+semver_ri_node *semver_ri_build(semver_ri_entry **es, size_t n,
+                                const semver_ri_point **points, int *err) {
+  semver_ri_node *node;
+  semver_ri_point center;
+  size_t i, n_left = 0, n_here = 0;
+  semver_ri_entry *t;
+
+  if (n == 0 || *err) {
+    return 0;
+  }
+  for (i = 0; i < n; i++) {
+    points[2 * i] = &es[i]->lower;
+    points[2 * i + 1] = &es[i]->upper;
+  }
+  qsort(points, 2 * n, sizeof(*points), semver_ri_point_qsort_cmp);
+  center = *points[n];
+
+  /* partition into entries below, containing and above the center */
+  for (i = 0; i < n; i++) {
+    if (semver_ri_point_cmp(&es[i]->upper, &center) < 0) {
+      t = es[n_left], es[n_left] = es[i], es[i] = t;
+      n_left++;
+    }
+  }
+  for (i = n_left; i < n; i++) {
+    if (semver_ri_point_cmp(&es[i]->lower, &center) <= 0) {
+      t = es[n_left + n_here], es[n_left + n_here] = es[i], es[i] = t;
+      n_here++;
+    }
+  }
+  node = semver_ri_node_new(&center, n_here);
+  if (!node) {
+    *err = 1;
+    return 0;
+  }
+  memcpy(node->by_lower, es + n_left, n_here * sizeof(semver_ri_entry *));
+  memcpy(node->by_upper, es + n_left, n_here * sizeof(semver_ri_entry *));
+  qsort(node->by_lower, n_here, sizeof(semver_ri_entry *),
+        semver_ri_lower_qsort_cmp);
+  qsort(node->by_upper, n_here, sizeof(semver_ri_entry *),
+        semver_ri_upper_qsort_cmp);
+  node->n = n_here;
+  node->weight = n;
+
+  node->left = semver_ri_build(es, n_left, points, err);
+  node->right =
+      semver_ri_build(es + n_left + n_here, n - n_left - n_here, points, err);
+  return node;
+}
+
+/**
+ * semver_ri_rebuild rebuilds the subtree at *slot balanced. If out of
+ * memory, the subtree is kept as it is.
+ */
+void semver_ri_rebuild(semver_ri_node **slot) {
+  size_t n = *slot ? (*slot)->weight : 0, k = 0;
+  const semver_ri_point **points;
+  semver_ri_entry **es;
+  semver_ri_node *node;
+  int err = 0;
+
+  if (n == 0) {
+    semver_ri_free_tree(*slot, 0);
+    *slot = 0;
+    return;
+  }
+  es = semver_malloc(n * sizeof(semver_ri_entry *));
+  points = semver_malloc(2 * n * sizeof(semver_ri_point *));
+  if (es && points) {
+    semver_ri_collect(*slot, es, &k);
+    node = semver_ri_build(es, n, points, &err);
+    if (err) {
+      semver_ri_free_tree(node, 0);
+    } else {
+      semver_ri_free_tree(*slot, 0);
+      *slot = node;
+    }
+  }
+  semver_free(es);
+  semver_free(points);
+}
+
+/**
+ * semver_req_index_limit returns the maximum depth of a tree of n entries,
+ * log to base 3/2 of n: deeper trees have a subtree whose weight exceeds
+ * 2/3 of its parent's.
+ */
+size_t semver_req_index_limit(size_t n) {
+  size_t d = 0, w = 1;
+
+  while (w < n) {
+    w = w + w / 2 + 1;
+    d++;
+  }
+  return d;
+}
+
+int semver_req_index_insert(semver_req_index self, semver_version_req req) {
+  semver_ri_node **path[SEMVER_RI_MAX_DEPTH + 1];
+  semver_ri_node **slot = &self->root;
+  semver_ri_entry *e, **p;
+  size_t d = 0, i;
+  int created = 0;
+
+  e = semver_malloc(sizeof(semver_ri_entry));
+  if (!e) {
+    return SEMVER_ERROR_OUT_OF_MEMORY;
+  }
+  semver_ri_entry_of(e, req);
+
+  if (semver_ri_point_cmp(&e->lower, &e->upper) > 0) {
+    if (self->n_empty == self->cap_empty) {
+      p = semver_realloc(self->empty,
+                         (2 * self->cap_empty + 4) * sizeof(semver_ri_entry *));
+      if (!p) {
+        semver_free(e);
+        return SEMVER_ERROR_OUT_OF_MEMORY;
+      }
+      self->empty = p;
+      self->cap_empty = 2 * self->cap_empty + 4;
+    }
+    self->empty[self->n_empty++] = e;
+    self->n++;
+    return SEMVER_OK;
+  }
+
+  /* descend to the first node whose center e contains */
+  while (*slot) {
+    if (d == SEMVER_RI_MAX_DEPTH) {
+      /* only if rebalancing failed for lack of memory */
+      semver_free(e);
+      return SEMVER_ERROR_OUT_OF_MEMORY;
+    }
+    path[d++] = slot;
+    if (semver_ri_point_cmp(&e->upper, &(*slot)->center) < 0) {
+      slot = &(*slot)->left;
+    } else if (semver_ri_point_cmp(&e->lower, &(*slot)->center) > 0) {
+      slot = &(*slot)->right;
+    } else {
+      break;
+    }
+  }
+  if (!*slot) {
+    path[d++] = slot;
+    *slot = semver_ri_node_new(
+        e->lower.side == SEMVER_RI_NEG_INF ? &e->upper : &e->lower, 0);
+    if (!*slot) {
+      semver_free(e);
+      return SEMVER_ERROR_OUT_OF_MEMORY;
+    }
+    created = 1;
+  }
+  if (!semver_ri_node_add(*slot, e)) {
+    if (created) {
+      semver_ri_free_tree(*slot, 0);
+      *slot = 0;
+    }
+    semver_free(e);
+    return SEMVER_ERROR_OUT_OF_MEMORY;
+  }
+  for (i = 0; i < d; i++) {
+    (*path[i])->weight++;
+  }
+  self->n++;
+  if (self->n > self->max_n) {
+    self->max_n = self->n;
+  }
+
+  /* too deep: rebuild the subtree of the lowest unbalanced ancestor */
+  if (d - 1 > semver_req_index_limit(self->n)) {
+    for (i = d - 1; i > 0; i--) {
+      if (3 * (*path[i])->weight > 2 * (*path[i - 1])->weight) {
+        break;
+      }
+    }
+    semver_ri_rebuild(path[i > 0 ? i - 1 : 0]);
+  }
+  return SEMVER_OK;
+}
+
+int semver_req_index_remove(semver_req_index self, semver_version_req req) {
+  semver_ri_node **path[SEMVER_RI_MAX_DEPTH + 1];
+  semver_ri_node **slot = &self->root;
+  semver_ri_entry key, *e = 0;
+  size_t d = 0, i;
+
+  semver_ri_entry_of(&key, req);
+  if (semver_ri_point_cmp(&key.lower, &key.upper) > 0) {
+    for (i = 0; i < self->n_empty; i++) {
+      if (self->empty[i]->req == req) {
+        e = self->empty[i];
+        self->empty[i] = self->empty[--self->n_empty];
+        break;
+      }
+    }
+  } else {
+    while (*slot && d <= SEMVER_RI_MAX_DEPTH) {
+      path[d++] = slot;
+      if (semver_ri_point_cmp(&key.upper, &(*slot)->center) < 0) {
+        slot = &(*slot)->left;
+      } else if (semver_ri_point_cmp(&key.lower, &(*slot)->center) > 0) {
+        slot = &(*slot)->right;
+      } else {
+        e = semver_ri_node_take(*slot, req);
+        break;
+      }
+    }
+    for (i = 0; e && i < d; i++) {
+      (*path[i])->weight--;
+    }
+  }
+  if (!e) {
+    return 0;
+  }
+  semver_free(e);
+  self->n--;
+
+  /* rebuild after half of the entries are gone, which keeps the depth
+   * within the limit of semver_req_index_insert */
+  if (self->n < self->max_n / 2) {
+    semver_ri_rebuild(&self->root);
+    self->max_n = self->n;
+  }
+  return 1;
+}
+
+size_t semver_req_index_stab(const semver_req_index self,
+                             const semver_version v, semver_version_req *out,
+                             size_t cap) {
+  const semver_ri_node *node = self->root;
+  semver_ri_point q;
+  size_t i, k = 0;
+  int c;
+
+  q.v = v;
+  q.k = semver_version_key_of(v);
+  q.side = SEMVER_RI_AT;
+
+  while (node) {
+    c = semver_ri_point_cmp(&q, &node->center);
+    if (c < 0) {
+      /* all entries reach above q, report the ones starting at q or below */
+      for (i = 0; i < node->n &&
+                  semver_ri_point_cmp(&node->by_lower[i]->lower, &q) <= 0;
+           i++, k++) {
+        if (k < cap) {
+          out[k] = node->by_lower[i]->req;
+        }
+      }
+      node = node->left;
+    } else if (c > 0) {
+      for (i = 0; i < node->n &&
+                  semver_ri_point_cmp(&node->by_upper[i]->upper, &q) >= 0;
+           i++, k++) {
+        if (k < cap) {
+          out[k] = node->by_upper[i]->req;
+        }
+      }
+      node = node->right;
+    } else {
+      for (i = 0; i < node->n; i++, k++) {
+        if (k < cap) {
+          out[k] = node->by_lower[i]->req;
+        }
+      }
+      break;
+    }
+  }
+  return k;
+}
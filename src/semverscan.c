@@ -0,0 +1,210 @@
+/*
+ * MIT License
+ *
+ * Copyright 2023 @aschmidt75
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdlib.h>
+
+#include "semver_impl.h"
+
+/*
+ * Vector paths are selected at compile time from the target's predefined
+ * macros, e.g. -mavx2 or -march=native. Define SEMVER_NO_SIMD to build the
+ * scalar path only.
+ */
+#if !defined(SEMVER_NO_SIMD) && defined(__GNUC__)
+#if defined(__SSE2__)
+#define SEMVER_SCAN_SSE2
+#include <emmintrin.h>
+#if defined(__AVX2__)
+#define SEMVER_SCAN_AVX2
+#include <immintrin.h>
+#endif
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#define SEMVER_SCAN_NEON
+#include <arm_neon.h>
+#endif
+#endif
+
+#define SEMVER_SCAN_CHAR(c, cls)                                               \
+  ((((c) >= '0') && ((c) <= '9')) || (((c) >= 'a') && ((c) <= 'z')) ||         \
+   (((c) >= 'A') && ((c) <= 'Z')) || ((c) == '-') || ((c) == '.') ||           \
+   ((cls) == SEMVER_SCAN_VERSION && (c) == '+'))
+
+size_t semver_scan_span_scalar(const char *s, size_t n, int cls,
+                               size_t *dots) {
+  size_t i;
+  size_t d = 0;
+
+  for (i = 0; i < n && SEMVER_SCAN_CHAR(s[i], cls); i++) {
+    d += (s[i] == '.');
+  }
+  if (dots) {
+    *dots += d;
+  }
+  return i;
+}
+
+/*
+ * Each vector step yields two bit masks over its bytes: bad has bits set
+ * for each byte outside of the character class, dot for each '.'.
+ * SEMVER_SCAN_STEP adds the dots in front of the first bad byte to d, and
+ * stops scanning there. SEMVER_SCAN_CTZ and SEMVER_SCAN_POPCOUNT must match
+ * the mask type.
+ */
+#define SEMVER_SCAN_STEP(bad, dot, bits_per_byte)                              \
+  do {                                                                         \
+    if (bad) {                                                                 \
+      d += SEMVER_SCAN_POPCOUNT((dot) & (((bad) & (0 - (bad))) - 1)) /         \
+           (bits_per_byte);                                                    \
+      i += SEMVER_SCAN_CTZ(bad) / (bits_per_byte);                             \
+      goto done;                                                               \
+    }                                                                          \
+    d += SEMVER_SCAN_POPCOUNT(dot) / (bits_per_byte);                          \
+  } while (0)
+
+#if defined(SEMVER_SCAN_SSE2)
+
+#define SEMVER_SCAN_CTZ(m) __builtin_ctz(m)
+#define SEMVER_SCAN_POPCOUNT(m) __builtin_popcount(m)
+
+size_t semver_scan_span(const char *s, size_t n, int cls, size_t *dots) {
+  size_t i = 0;
+  size_t d = 0;
+  unsigned int bad, dot;
+
+#if defined(SEMVER_SCAN_AVX2)
+  {
+    const __m256i lo0 = _mm256_set1_epi8('0' - 1);
+    const __m256i hi9 = _mm256_set1_epi8('9' + 1);
+    const __m256i loa = _mm256_set1_epi8('a' - 1);
+    const __m256i hiz = _mm256_set1_epi8('z' + 1);
+    const __m256i case_bit = _mm256_set1_epi8(0x20);
+    const __m256i c_dot = _mm256_set1_epi8('.');
+    const __m256i c_dash = _mm256_set1_epi8('-');
+    const __m256i c_plus =
+        _mm256_set1_epi8(cls == SEMVER_SCAN_VERSION ? '+' : '.');
+
+    for (; i + 32 <= n; i += 32) {
+      __m256i x = _mm256_loadu_si256((const __m256i *)(s + i));
+      __m256i l = _mm256_or_si256(x, case_bit);
+      __m256i is_dot = _mm256_cmpeq_epi8(x, c_dot);
+      __m256i ok = _mm256_and_si256(_mm256_cmpgt_epi8(x, lo0),
+                                    _mm256_cmpgt_epi8(hi9, x));
+      ok = _mm256_or_si256(ok, _mm256_and_si256(_mm256_cmpgt_epi8(l, loa),
+                                                _mm256_cmpgt_epi8(hiz, l)));
+      ok = _mm256_or_si256(ok, is_dot);
+      ok = _mm256_or_si256(ok, _mm256_cmpeq_epi8(x, c_dash));
+      ok = _mm256_or_si256(ok, _mm256_cmpeq_epi8(x, c_plus));
+      bad = ~(unsigned int)_mm256_movemask_epi8(ok);
+      dot = (unsigned int)_mm256_movemask_epi8(is_dot);
+      SEMVER_SCAN_STEP(bad, dot, 1);
+    }
+  }
+#endif
+  {
+    const __m128i lo0 = _mm_set1_epi8('0' - 1);
+    const __m128i hi9 = _mm_set1_epi8('9' + 1);
+    const __m128i loa = _mm_set1_epi8('a' - 1);
+    const __m128i hiz = _mm_set1_epi8('z' + 1);
+    const __m128i case_bit = _mm_set1_epi8(0x20);
+    const __m128i c_dot = _mm_set1_epi8('.');
+    const __m128i c_dash = _mm_set1_epi8('-');
+    /* '.' again if '+' is not part of the class */
+    const __m128i c_plus = _mm_set1_epi8(cls == SEMVER_SCAN_VERSION ? '+' : '.');
+
+    /* signed compares: bytes >= 0x80 are negative and never in range */
+    for (; i + 16 <= n; i += 16) {
+      __m128i x = _mm_loadu_si128((const __m128i *)(s + i));
+      __m128i l = _mm_or_si128(x, case_bit);
+      __m128i is_dot = _mm_cmpeq_epi8(x, c_dot);
+      __m128i ok = _mm_and_si128(_mm_cmpgt_epi8(x, lo0), _mm_cmplt_epi8(x, hi9));
+      ok = _mm_or_si128(ok, _mm_and_si128(_mm_cmpgt_epi8(l, loa),
+                                          _mm_cmplt_epi8(l, hiz)));
+      ok = _mm_or_si128(ok, is_dot);
+      ok = _mm_or_si128(ok, _mm_cmpeq_epi8(x, c_dash));
+      ok = _mm_or_si128(ok, _mm_cmpeq_epi8(x, c_plus));
+      bad = ~(unsigned int)_mm_movemask_epi8(ok) & 0xffffU;
+      dot = (unsigned int)_mm_movemask_epi8(is_dot);
+      SEMVER_SCAN_STEP(bad, dot, 1);
+    }
+  }
+  i += semver_scan_span_scalar(s + i, n - i, cls, &d);
+
+done:
+  if (dots) {
+    *dots += d;
+  }
+  return i;
+}
+
+#elif defined(SEMVER_SCAN_NEON)
+
+/* uint64_t is unsigned long on aarch64 */
+#define SEMVER_SCAN_CTZ(m) __builtin_ctzl(m)
+#define SEMVER_SCAN_POPCOUNT(m) __builtin_popcountl(m)
+
+size_t semver_scan_span(const char *s, size_t n, int cls, size_t *dots) {
+  size_t i = 0;
+  size_t d = 0;
+  uint64_t bad, dot;
+  const uint8x16_t c0 = vdupq_n_u8('0');
+  const uint8x16_t c9 = vdupq_n_u8('9');
+  const uint8x16_t ca = vdupq_n_u8('a');
+  const uint8x16_t cz = vdupq_n_u8('z');
+  const uint8x16_t case_bit = vdupq_n_u8(0x20);
+  const uint8x16_t c_dot = vdupq_n_u8('.');
+  const uint8x16_t c_dash = vdupq_n_u8('-');
+  const uint8x16_t c_plus = vdupq_n_u8(cls == SEMVER_SCAN_VERSION ? '+' : '.');
+
+  for (; i + 16 <= n; i += 16) {
+    uint8x16_t x = vld1q_u8((const uint8_t *)(s + i));
+    uint8x16_t l = vorrq_u8(x, case_bit);
+    uint8x16_t is_dot = vceqq_u8(x, c_dot);
+    uint8x16_t ok = vandq_u8(vcgeq_u8(x, c0), vcleq_u8(x, c9));
+    ok = vorrq_u8(ok, vandq_u8(vcgeq_u8(l, ca), vcleq_u8(l, cz)));
+    ok = vorrq_u8(ok, is_dot);
+    ok = vorrq_u8(ok, vceqq_u8(x, c_dash));
+    ok = vorrq_u8(ok, vceqq_u8(x, c_plus));
+    /* narrow to 4 bits per byte, there is no movemask */
+    bad = ~vget_lane_u64(
+        vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(ok), 4)), 0);
+    dot = vget_lane_u64(
+        vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(is_dot), 4)), 0);
+    SEMVER_SCAN_STEP(bad, dot, 4);
+  }
+  i += semver_scan_span_scalar(s + i, n - i, cls, &d);
+
+done:
+  if (dots) {
+    *dots += d;
+  }
+  return i;
+}
+
+#else
+
+size_t semver_scan_span(const char *s, size_t n, int cls, size_t *dots) {
+  return semver_scan_span_scalar(s, n, cls, dots);
+}
+
+#endif
@@ -0,0 +1,670 @@
+/*
+ * MIT License
+ *
+ * Copyright 2023 @aschmidt75
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifdef SEMVER_HAVE_PTHREAD
+#define _POSIX_C_SOURCE 200112L
+#include <pthread.h>
+#endif
+#include <stdlib.h>
+#include <string.h>
+
+#include "semver.h"
+#include "semverarena.h"
+#include "semversort.h"
+#include "semver_impl.h"
+
+/* number of radix digits (bytes) of a key */
+#define SEMVER_SORT_DIGITS (2 * sizeof(unsigned long))
+/* number of counters of semver_sort_records */
+#define SEMVER_SORT_COUNTS (SEMVER_SORT_DIGITS * 256)
+/* below this size, ranges are sorted by insertion */
+#define SEMVER_SORT_SMALL 24
+
+/* byte d of a key, 0 being the least significant one of lo */
+#define SEMVER_SORT_DIGIT(k, d)                                                \
+  ((unsigned int)((((d) < sizeof(unsigned long))                               \
+                       ? ((k).lo >> (8 * (d)))                                 \
+                       : ((k).hi >> (8 * ((d) - sizeof(unsigned long))))) &    \
+                  0xff))
+
+int semver_sort_rec_cmp(const semver_sort_rec *a, const semver_sort_rec *b,
+                        const semver_version *vs) {
+  return semver_version_cmp_keyed(vs[a->idx], &a->key, vs[b->idx], &b->key);
+}
+
+/**
+ * semver_sort_insertion sorts rec[0..n) in place, stable.
+ */
+void semver_sort_insertion(semver_sort_rec *rec, size_t n,
+                           const semver_version *vs) {
+  semver_sort_rec r;
+  size_t i, j;
+
+  for (i = 1; i < n; i++) {
+    r = rec[i];
+    for (j = i; j > 0 && semver_sort_rec_cmp(&rec[j - 1], &r, vs) > 0; j--) {
+      rec[j] = rec[j - 1];
+    }
+    rec[j] = r;
+  }
+}
+
+/**
+ * semver_sort_merge sorts rec[0..n) with a stable merge sort, using tmp[0..n)
+ * as scratch space.
+ */
+void semver_sort_merge(semver_sort_rec *rec, semver_sort_rec *tmp, size_t n,
+                       const semver_version *vs) {
+  size_t h = n / 2;
+  size_t i = 0, j = h, k = 0;
+
+  if (n < SEMVER_SORT_SMALL) {
+    semver_sort_insertion(rec, n, vs);
+    return;
+  }
+  semver_sort_merge(rec, tmp, h, vs);
+  semver_sort_merge(rec + h, tmp + h, n - h, vs);
+  if (semver_sort_rec_cmp(&rec[h - 1], &rec[h], vs) <= 0) {
+    return;
+  }
+  while (i < h && j < n) {
+    /* ties take from the left half, which keeps the sort stable */
+    if (semver_sort_rec_cmp(&rec[j], &rec[i], vs) < 0) {
+      tmp[k++] = rec[j++];
+    } else {
+      tmp[k++] = rec[i++];
+    }
+  }
+  while (i < h) {
+    tmp[k++] = rec[i++];
+  }
+  /* rest of the right half is in place already */
+  memcpy(rec, tmp, k * sizeof(semver_sort_rec));
+}
+
+/**
+ * semver_sort_records sorts rec[0..n) by precedence of the versions vs[idx],
+ * stable. Keys are sorted by a LSD radix sort, skipping digits that are the
+ * same for all keys, then ranges of equal keys are sorted by comparing
+ * versions. tmp must hold n records and counts SEMVER_SORT_COUNTS counters.
+ * Returns rec or tmp, whichever holds the result.
+ */
+semver_sort_rec *semver_sort_records(semver_sort_rec *rec,
+                                     semver_sort_rec *tmp, size_t n,
+                                     const semver_version *vs,
+                                     size_t *counts) {
+  semver_sort_rec *src = rec;
+  semver_sort_rec *dst = tmp;
+  semver_sort_rec *swap;
+  size_t *c;
+  size_t i, j, d, sum, x;
+
+  if (n < SEMVER_SORT_SMALL) {
+    semver_sort_insertion(rec, n, vs);
+    return rec;
+  }
+
+  /* histograms of all digits in one pass */
+  memset(counts, 0, SEMVER_SORT_COUNTS * sizeof(size_t));
+  for (i = 0; i < n; i++) {
+    for (d = 0; d < SEMVER_SORT_DIGITS; d++) {
+      counts[d * 256 + SEMVER_SORT_DIGIT(src[i].key, d)]++;
+    }
+  }
+
+  for (d = 0; d < SEMVER_SORT_DIGITS; d++) {
+    c = counts + d * 256;
+    if (c[SEMVER_SORT_DIGIT(src[0].key, d)] == n) {
+      /* all keys share this digit */
+      continue;
+    }
+    for (sum = 0, j = 0; j < 256; j++) {
+      x = c[j];
+      c[j] = sum;
+      sum += x;
+    }
+    for (i = 0; i < n; i++) {
+      dst[c[SEMVER_SORT_DIGIT(src[i].key, d)]++] = src[i];
+    }
+    swap = src;
+    src = dst;
+    dst = swap;
+  }
+
+  /* order ranges of equal keys, e.g. prereleases of the same version */
+  for (i = 0; i < n; i = j) {
+    for (j = i + 1; j < n && src[j].key.hi == src[i].key.hi &&
+                    src[j].key.lo == src[i].key.lo;
+         j++) {
+    }
+    if (j - i > 1) {
+      semver_sort_merge(src + i, dst + i, j - i, vs);
+    }
+  }
+
+  return src;
+}
+
+/**
+ * semver_sort_unique moves records of equal precedence behind the first one
+ * of them to the end, keeping their order. dst receives the result.
+ * Returns the number of distinct records.
+ */
+size_t semver_sort_unique(const semver_sort_rec *src, semver_sort_rec *dst,
+                          size_t n, const semver_version *vs) {
+  size_t i, u = 0, k;
+
+  for (i = 0; i < n; i++) {
+    if (i == 0 || semver_sort_rec_cmp(&src[i - 1], &src[i], vs) != 0) {
+      u++;
+    }
+  }
+  k = u;
+  u = 0;
+  for (i = 0; i < n; i++) {
+    if (i == 0 || semver_sort_rec_cmp(&src[i - 1], &src[i], vs) != 0) {
+      dst[u++] = src[i];
+    } else {
+      dst[k++] = src[i];
+    }
+  }
+  return u;
+}
+
+#ifdef SEMVER_HAVE_PTHREAD
+
+/* below this size, sorting is not worth starting threads */
+#define SEMVER_SORT_PARALLEL_MIN 16384
+/* upper bound of threads of a parallel sort */
+#define SEMVER_SORT_MAX_THREADS 256
+/* number of sampled keys per thread, to choose bucket boundaries */
+#define SEMVER_SORT_SAMPLES 64
+
+/**
+ * semver_sort_par is the state shared by the threads of a parallel sort.
+ * Records are distributed into one bucket per thread by key ranges, so that
+ * equal keys end up in the same bucket, then each bucket is sorted on its
+ * own. Distribution keeps the input order within buckets, which makes the
+ * result identical to the serial sort.
+ */
+typedef struct {
+  const semver_version *vs;
+  semver_sort_rec *rec;
+  semver_sort_rec *tmp;
+  size_t n;
+  size_t n_threads;
+  /* n_threads - 1 upper bounds of buckets, ascending */
+  semver_version_key *splitters;
+  /* [chunk * n_threads + bucket]: number of records of an input chunk
+   * falling into a bucket, turned into their offsets before distribution */
+  size_t *chunk_counts;
+  /* n_threads + 1 offsets of buckets */
+  size_t *bucket_start;
+  /* per thread radix sort counters */
+  size_t *counts;
+  int phase;
+} semver_sort_par;
+
+typedef struct {
+  semver_sort_par *par;
+  size_t t;
+} semver_sort_task;
+
+/**
+ * semver_sort_bucket returns the bucket of a key: the first one whose upper
+ * bound is not less than the key.
+ */
+size_t semver_sort_bucket(const semver_sort_par *par,
+                          const semver_version_key *key) {
+  size_t lo = 0;
+  size_t hi = par->n_threads - 1;
+  size_t mid;
+
+  while (lo < hi) {
+    mid = lo + (hi - lo) / 2;
+    if (semver_version_key_cmp(key, &par->splitters[mid]) <= 0) {
+      hi = mid;
+    } else {
+      lo = mid + 1;
+    }
+  }
+  return lo;
+}
+
+/**
+ * semver_sort_worker runs the current phase of a parallel sort for chunk or
+ * bucket t.
+ */
+void *semver_sort_worker(void *arg) {
+  semver_sort_task *task = (semver_sort_task *)arg;
+  semver_sort_par *par = task->par;
+  size_t t = task->t;
+  size_t T = par->n_threads;
+  size_t begin = par->n * t / T;
+  size_t end = par->n * (t + 1) / T;
+  size_t *c = par->chunk_counts + t * T;
+  semver_sort_rec *out;
+  size_t i;
+
+  switch (par->phase) {
+  case 0:
+    /* compute keys of chunk t, count them per bucket */
+    for (i = begin; i < end; i++) {
+      par->rec[i].key = semver_version_key_of(par->vs[i]);
+      par->rec[i].idx = i;
+      c[semver_sort_bucket(par, &par->rec[i].key)]++;
+    }
+    break;
+  case 1:
+    /* distribute chunk t into buckets */
+    for (i = begin; i < end; i++) {
+      par->tmp[c[semver_sort_bucket(par, &par->rec[i].key)]++] = par->rec[i];
+    }
+    break;
+  default:
+    /* sort bucket t, result goes to tmp */
+    begin = par->bucket_start[t];
+    end = par->bucket_start[t + 1];
+    out = semver_sort_records(par->tmp + begin, par->rec + begin, end - begin,
+                              par->vs, par->counts + t * SEMVER_SORT_COUNTS);
+    if (out != par->tmp + begin) {
+      memcpy(par->tmp + begin, out, (end - begin) * sizeof(semver_sort_rec));
+    }
+    break;
+  }
+  return 0;
+}
+
+/**
+ * semver_sort_phase runs a phase of a parallel sort on all threads. Tasks
+ * whose thread cannot be started run on the calling thread.
+ */
+void semver_sort_phase(semver_sort_par *par, int phase) {
+  pthread_t threads[SEMVER_SORT_MAX_THREADS];
+  int started[SEMVER_SORT_MAX_THREADS];
+  semver_sort_task tasks[SEMVER_SORT_MAX_THREADS];
+  size_t t;
+
+  par->phase = phase;
+  for (t = 0; t < par->n_threads; t++) {
+    tasks[t].par = par;
+    tasks[t].t = t;
+    started[t] = t > 0 && pthread_create(&threads[t], NULL, semver_sort_worker,
+                                         &tasks[t]) == 0;
+  }
+  for (t = 0; t < par->n_threads; t++) {
+    if (!started[t]) {
+      semver_sort_worker(&tasks[t]);
+    }
+  }
+  for (t = 1; t < par->n_threads; t++) {
+    if (started[t]) {
+      pthread_join(threads[t], NULL);
+    }
+  }
+}
+
+int semver_sort_key_qsort_cmp(const void *a, const void *b) {
+  return semver_version_key_cmp((const semver_version_key *)a,
+                                (const semver_version_key *)b);
+}
+
+/**
+ * semver_sort_run_parallel is semver_sort_run on n_threads threads.
+ */
+size_t semver_sort_run_parallel(const semver_version *vs, size_t n, int flags,
+                                unsigned int n_threads, semver_sort_rec **res,
+                                void **block) {
+  semver_sort_par par;
+  semver_sort_rec *out;
+  size_t T = n_threads > SEMVER_SORT_MAX_THREADS ? SEMVER_SORT_MAX_THREADS
+                                                 : n_threads;
+  size_t n_samples = T * SEMVER_SORT_SAMPLES;
+  size_t b, t, sum, x, u = n;
+
+  *block = semver_malloc(
+      (2 * n + 1) * sizeof(semver_sort_rec) +
+      (T * SEMVER_SORT_COUNTS + T * T + T + 1) * sizeof(size_t) +
+      n_samples * sizeof(semver_version_key));
+  if (!*block) {
+    return (size_t)-1;
+  }
+  par.vs = vs;
+  par.n = n;
+  par.n_threads = T;
+  par.rec = (semver_sort_rec *)*block;
+  par.tmp = par.rec + n;
+  par.counts = (size_t *)(par.tmp + n + 1);
+  par.chunk_counts = par.counts + T * SEMVER_SORT_COUNTS;
+  par.bucket_start = par.chunk_counts + T * T;
+  par.splitters = (semver_version_key *)(par.bucket_start + T + 1);
+
+  /* bucket boundaries from evenly spaced samples */
+  for (x = 0; x < n_samples; x++) {
+    par.splitters[x] = semver_version_key_of(vs[n / n_samples * x]);
+  }
+  qsort(par.splitters, n_samples, sizeof(semver_version_key),
+        semver_sort_key_qsort_cmp);
+  for (b = 0; b + 1 < T; b++) {
+    par.splitters[b] = par.splitters[(b + 1) * SEMVER_SORT_SAMPLES];
+  }
+
+  memset(par.chunk_counts, 0, T * T * sizeof(size_t));
+  semver_sort_phase(&par, 0);
+
+  /* offsets of chunks within buckets, in input order */
+  for (sum = 0, b = 0; b < T; b++) {
+    par.bucket_start[b] = sum;
+    for (t = 0; t < T; t++) {
+      x = par.chunk_counts[t * T + b];
+      par.chunk_counts[t * T + b] = sum;
+      sum += x;
+    }
+  }
+  par.bucket_start[T] = n;
+
+  semver_sort_phase(&par, 1);
+  semver_sort_phase(&par, 2);
+
+  out = par.tmp;
+  if (flags & SEMVER_SORT_UNIQUE) {
+    u = semver_sort_unique(par.tmp, par.rec, n, vs);
+    out = par.rec;
+  }
+  *res = out;
+  return u;
+}
+
+#endif
+
+/**
+ * semver_sort_run sorts versions vs[0..n), using up to n_threads threads.
+ * Sets *res to the resulting order of records, which live in *block, to be
+ * freed by the caller. Returns the number of distinct versions if
+ * SEMVER_SORT_UNIQUE is given, n otherwise, or (size_t)-1 if out of memory.
+ */
+size_t semver_sort_run(const semver_version *vs, size_t n, int flags,
+                       unsigned int n_threads, semver_sort_rec **res,
+                       void **block) {
+  semver_sort_rec *rec, *tmp, *out;
+  size_t *counts;
+  size_t i, u = n;
+
+#ifdef SEMVER_HAVE_PTHREAD
+  if (n_threads > 1 && n >= SEMVER_SORT_PARALLEL_MIN) {
+    return semver_sort_run_parallel(vs, n, flags, n_threads, res, block);
+  }
+#endif
+
+  /* one record at least, so that n == 0 is not an out of memory case */
+  *block = semver_malloc((2 * n + 1) * sizeof(semver_sort_rec) +
+                         SEMVER_SORT_COUNTS * sizeof(size_t));
+  if (!*block) {
+    return (size_t)-1;
+  }
+  rec = (semver_sort_rec *)*block;
+  tmp = rec + n;
+  counts = (size_t *)(tmp + n);
+
+  for (i = 0; i < n; i++) {
+    rec[i].key = semver_version_key_of(vs[i]);
+    rec[i].idx = i;
+  }
+  out = semver_sort_records(rec, tmp, n, vs, counts);
+  if (flags & SEMVER_SORT_UNIQUE) {
+    u = semver_sort_unique(out, out == rec ? tmp : rec, n, vs);
+    out = out == rec ? tmp : rec;
+  }
+  *res = out;
+  return u;
+}
+
+int semver_version_sort_parallel(semver_version *arr, size_t n, int flags,
+                                 size_t *n_out, unsigned int n_threads) {
+  semver_version *vs;
+  semver_sort_rec *out;
+  void *block;
+  size_t i, u;
+
+  if (n_out) {
+    *n_out = n;
+  }
+  if (n < 2) {
+    return SEMVER_OK;
+  }
+  vs = semver_malloc(n * sizeof(semver_version));
+  if (!vs) {
+    return SEMVER_ERROR_OUT_OF_MEMORY;
+  }
+  memcpy(vs, arr, n * sizeof(semver_version));
+  u = semver_sort_run(vs, n, flags, n_threads, &out, &block);
+  if (u == (size_t)-1) {
+    semver_free(vs);
+    return SEMVER_ERROR_OUT_OF_MEMORY;
+  }
+  for (i = 0; i < n; i++) {
+    arr[i] = vs[out[i].idx];
+  }
+  if (n_out) {
+    *n_out = u;
+  }
+  semver_free(block);
+  semver_free(vs);
+
+  return SEMVER_OK;
+}
+
+int semver_version_sort_flags(semver_version *arr, size_t n, int flags,
+                              size_t *n_out) {
+  return semver_version_sort_parallel(arr, n, flags, n_out, 1);
+}
+
+int semver_version_sort(semver_version *arr, size_t n) {
+  return semver_version_sort_flags(arr, n, 0, 0);
+}
+
+int semver_version_sort_strings(const char **strs, size_t n, int flags,
+                                size_t *n_out) {
+  semver_arena arena;
+  semver_version_wrapped w;
+  semver_version *vs;
+  const char **valid, **invalid;
+  semver_sort_rec *out;
+  void *block = 0;
+  size_t i, m = 0, u;
+  int k = SEMVER_OK;
+
+  if (n_out) {
+    *n_out = 0;
+  }
+  if (n == 0) {
+    return SEMVER_OK;
+  }
+  arena = semver_arena_new(0);
+  vs = semver_malloc(n * (sizeof(semver_version) + 2 * sizeof(const char *)));
+  if (!arena || !vs) {
+    k = SEMVER_ERROR_OUT_OF_MEMORY;
+    goto out;
+  }
+  valid = (const char **)(vs + n);
+  invalid = valid + n;
+
+  for (i = 0; i < n; i++) {
+    w = semver_version_from_string_wrapped_in(arena, strs[i]);
+    if (!w.err) {
+      vs[m] = w.unwrap.result;
+      valid[m++] = strs[i];
+    } else if (w.unwrap.code == SEMVER_ERROR_OUT_OF_MEMORY) {
+      k = SEMVER_ERROR_OUT_OF_MEMORY;
+      goto out;
+    } else {
+      invalid[i - m] = strs[i];
+    }
+  }
+
+  u = semver_sort_run(vs, m, flags, 1, &out, &block);
+  if (u == (size_t)-1) {
+    k = SEMVER_ERROR_OUT_OF_MEMORY;
+    goto out;
+  }
+  for (i = 0; i < m; i++) {
+    strs[i] = valid[out[i].idx];
+  }
+  /* strings that could not be parsed keep their order behind them */
+  memcpy(strs + m, invalid, (n - m) * sizeof(const char *));
+  if (n_out) {
+    *n_out = u;
+  }
+
+out:
+  semver_free(block);
+  semver_free(vs);
+  semver_arena_delete(arena);
+  return k;
+}
+
+size_t semver_sort_copy_in(semver_arena arena, const semver_version *vs,
+                           size_t n, int flags, semver_version **out,
+                           semver_version_key **keys) {
+  semver_sort_rec *res = 0;
+  void *block = 0;
+  size_t u, i;
+
+  u = n > 0 ? semver_sort_run(vs, n, flags, 1, &res, &block) : 0;
+  if (u == (size_t)-1) {
+    return u;
+  }
+  *out = semver_arena_alloc(arena, (u + 1) * sizeof(semver_version));
+  *keys = semver_arena_alloc(arena, (u + 1) * sizeof(semver_version_key));
+  if (!*out || !*keys) {
+    u = (size_t)-1;
+    goto out;
+  }
+  for (i = 0; i < u; i++) {
+    (*out)[i] = semver_version_from_copy_in(arena, vs[res[i].idx]);
+    if (!(*out)[i]) {
+      u = (size_t)-1;
+      goto out;
+    }
+    (*keys)[i] = res[i].key;
+  }
+
+out:
+  semver_free(block);
+  return u;
+}
+
+size_t semver_sort_search_by(semver_sort_cmp_fn cmp, const void *ctx,
+                             size_t n, const semver_version v, int above) {
+  semver_version_key k = semver_version_key_of(v);
+  size_t lo = 0, hi = n, mid;
+  int c;
+
+  while (lo < hi) {
+    mid = lo + (hi - lo) / 2;
+    c = cmp(ctx, mid, v, &k);
+    if (c < 0 || (c == 0 && above)) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+size_t semver_sort_req_range_by(semver_sort_cmp_fn cmp, const void *ctx,
+                                size_t n, const semver_version_req req,
+                                size_t *begin, size_t *end) {
+  semver_version lower, upper;
+  int lower_including, upper_including;
+
+  semver_version_req_bounds(req, &lower, &lower_including, &upper,
+                            &upper_including);
+  *begin = lower ? semver_sort_search_by(cmp, ctx, n, lower, !lower_including)
+                 : 0;
+  *end = upper ? semver_sort_search_by(cmp, ctx, n, upper, upper_including) : n;
+  if (*end < *begin) {
+    *end = *begin;
+  }
+  return *end - *begin;
+}
+
+/** semver_sort_array is a sorted array of versions, with optional keys */
+typedef struct {
+  const semver_version *vs;
+  const semver_version_key *keys;
+} semver_sort_array;
+
+/** semver_sort_array_cmp is the semver_sort_cmp_fn of semver_sort_array */
+int semver_sort_array_cmp(const void *ctx, size_t i, const semver_version v,
+                          const semver_version_key *k) {
+  const semver_sort_array *a = ctx;
+  return a->keys ? semver_version_cmp_keyed(a->vs[i], &a->keys[i], v, k)
+                 : semver_version_cmp(a->vs[i], v);
+}
+
+size_t semver_sort_search(const semver_version *vs,
+                          const semver_version_key *keys, size_t n,
+                          const semver_version v, int above) {
+  semver_sort_array a;
+
+  a.vs = vs;
+  a.keys = keys;
+  return semver_sort_search_by(semver_sort_array_cmp, &a, n, v, above);
+}
+
+size_t semver_sort_req_range(const semver_version *vs,
+                             const semver_version_key *keys, size_t n,
+                             const semver_version_req req, size_t *begin,
+                             size_t *end) {
+  semver_sort_array a;
+
+  a.vs = vs;
+  a.keys = keys;
+  return semver_sort_req_range_by(semver_sort_array_cmp, &a, n, req, begin,
+                                  end);
+}
+
+size_t semver_version_lower_bound(const semver_version *arr, size_t n,
+                                  const semver_version v) {
+  return semver_sort_search(arr, 0, n, v, 0);
+}
+
+size_t semver_version_upper_bound(const semver_version *arr, size_t n,
+                                  const semver_version v) {
+  return semver_sort_search(arr, 0, n, v, 1);
+}
+
+size_t semver_version_req_range(const semver_version_req req,
+                                const semver_version *arr, size_t n,
+                                size_t *begin, size_t *end) {
+  return semver_sort_req_range(arr, 0, n, req, begin, end);
+}
+
+size_t semver_version_req_range_keyed(const semver_version_req req,
+                                      const semver_version *arr,
+                                      const semver_version_key *keys, size_t n,
+                                      size_t *begin, size_t *end) {
+  return semver_sort_req_range(arr, keys, n, req, begin, end);
+}
@@ -0,0 +1,657 @@
+/*
+ * MIT License
+ *
+ * Copyright 2023 @aschmidt75
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/* mkstemp, read, pread, write, lseek and unlink are POSIX */
+#define _POSIX_C_SOURCE 200809L
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "semver.h"
+#include "semverarena.h"
+#include "semversort.h"
+#include "semver_impl.h"
+
+/* maximum number of runs merged at once */
+#define SEMVER_SORT_FANIN 64
+/* size of I/O buffers, within the memory budget */
+#define SEMVER_SORT_IO_MIN 4096
+#define SEMVER_SORT_IO_MAX 65536
+/* length of a line that is too long to be a version */
+#define SEMVER_SORT_OVERLONG ((size_t)-1)
+
+/**
+ * semver_sort_reader reads lines from a file descriptor through a buffer,
+ * from its current position, or from the range [off, end) if end >= 0.
+ */
+typedef struct {
+  int fd;
+  char *buf;
+  size_t size;
+  size_t pos;
+  size_t len;
+  int eof;
+  /* set while skipping the rest of an overlong line */
+  int skip;
+  off_t off;
+  off_t end;
+} semver_sort_reader;
+
+/**
+ * semver_sort_writer writes to a file descriptor through a buffer.
+ */
+typedef struct {
+  int fd;
+  char *buf;
+  size_t size;
+  size_t len;
+} semver_sort_writer;
+
+/**
+ * semver_sort_cursor is the current line of a run being merged, parsed.
+ */
+typedef struct {
+  semver_sort_reader r;
+  semver_version_storage mem;
+  semver_version v;
+  semver_version_key key;
+  size_t run;
+} semver_sort_cursor;
+
+/**
+ * semver_sort_reader_line returns the next line of r without its newline in
+ * *line and *n. Lines not fitting the buffer are returned with *n set to
+ * SEMVER_SORT_OVERLONG. Returns 1 for a line, 0 at end of file, or -1 if
+ * reading failed.
+ */
+int semver_sort_reader_line(semver_sort_reader *r, const char **line,
+                            size_t *n) {
+  char *nl;
+  ssize_t k;
+  size_t m;
+
+  for (;;) {
+    nl = r->pos < r->len ? memchr(r->buf + r->pos, '\n', r->len - r->pos) : 0;
+    if (nl) {
+      *line = r->buf + r->pos;
+      *n = nl - *line;
+      r->pos += *n + 1;
+      if (r->skip) {
+        r->skip = 0;
+        *n = SEMVER_SORT_OVERLONG;
+      }
+      return 1;
+    }
+    if (r->eof) {
+      if (r->pos == r->len && !r->skip) {
+        return 0;
+      }
+      /* last line without newline */
+      *line = r->buf + r->pos;
+      *n = r->skip ? SEMVER_SORT_OVERLONG : r->len - r->pos;
+      r->pos = r->len;
+      r->skip = 0;
+      return 1;
+    }
+    if (r->pos > 0) {
+      memmove(r->buf, r->buf + r->pos, r->len - r->pos);
+      r->len -= r->pos;
+      r->pos = 0;
+    } else if (r->len == r->size) {
+      /* no newline within the whole buffer */
+      r->skip = 1;
+      r->len = 0;
+    }
+    if (r->end < 0) {
+      k = read(r->fd, r->buf + r->len, r->size - r->len);
+    } else {
+      m = r->size - r->len;
+      if ((off_t)m > r->end - r->off) {
+        m = (size_t)(r->end - r->off);
+      }
+      k = m > 0 ? pread(r->fd, r->buf + r->len, m, r->off) : 0;
+      if (k > 0) {
+        r->off += k;
+      }
+    }
+    if (k < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return -1;
+    }
+    if (k == 0) {
+      r->eof = 1;
+    }
+    r->len += k;
+  }
+}
+
+/**
+ * semver_sort_write writes all of buf to fd. Returns 0, or -1 if writing
+ * failed.
+ */
+int semver_sort_write(int fd, const char *buf, size_t n) {
+  ssize_t k;
+
+  while (n > 0) {
+    k = write(fd, buf, n);
+    if (k < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return -1;
+    }
+    buf += k;
+    n -= k;
+  }
+  return 0;
+}
+
+int semver_sort_writer_flush(semver_sort_writer *w) {
+  int k = semver_sort_write(w->fd, w->buf, w->len);
+  w->len = 0;
+  return k;
+}
+
+/**
+ * semver_sort_writer_put writes a version as a line. Returns 0, or -1 if
+ * writing failed.
+ */
+int semver_sort_writer_put(semver_sort_writer *w, const semver_version v) {
+  if (w->size - w->len < SEMVER_MAXLEN + 1 && semver_sort_writer_flush(w)) {
+    return -1;
+  }
+  w->len += semver_version_sprint(v, w->buf + w->len);
+  w->buf[w->len++] = '\n';
+  return 0;
+}
+
+/**
+ * semver_sort_tmpfile creates an unlinked temporary file in dir. Returns its
+ * file descriptor, or -1.
+ */
+int semver_sort_tmpfile(const char *dir) {
+  const char *name = "/semver-sort-XXXXXX";
+  char *path;
+  int fd;
+
+  path = semver_malloc(strlen(dir) + strlen(name) + 1);
+  if (!path) {
+    return -1;
+  }
+  strcpy(path, dir);
+  strcat(path, name);
+  fd = mkstemp(path);
+  if (fd >= 0) {
+    unlink(path);
+  }
+  semver_free(path);
+  return fd;
+}
+
+/**
+ * semver_sort_cursor_next advances a cursor to the next line of its run.
+ * Returns 1, 0 at end of the run, or a negative value if reading failed.
+ */
+int semver_sort_cursor_next(semver_sort_cursor *c) {
+  const char *line;
+  size_t n;
+  int k;
+
+  if (c->v) {
+    semver_version_destroy(c->v);
+    c->v = 0;
+  }
+  k = semver_sort_reader_line(&c->r, &line, &n);
+  if (k <= 0) {
+    return k;
+  }
+  /* runs hold versions written by us, valid unless out of memory */
+  c->v = semver_version_init_from_strn(&c->mem, line, n);
+  if (!c->v) {
+    return -2;
+  }
+  c->key = semver_version_key_of(c->v);
+  return 1;
+}
+
+/**
+ * semver_sort_cursor_less orders cursors by their version, then by run,
+ * which keeps the merge stable.
+ */
+int semver_sort_cursor_less(const semver_sort_cursor *a,
+                            const semver_sort_cursor *b) {
+  int k = semver_version_cmp_keyed(a->v, &a->key, b->v, &b->key);
+  return k < 0 || (k == 0 && a->run < b->run);
+}
+
+/**
+ * semver_sort_heap_down restores the min-heap property of heap[0..n) from
+ * position i downwards.
+ */
+void semver_sort_heap_down(semver_sort_cursor **heap, size_t n, size_t i) {
+  semver_sort_cursor *c = heap[i];
+  size_t j;
+
+  for (;;) {
+    j = 2 * i + 1;
+    if (j >= n) {
+      break;
+    }
+    if (j + 1 < n && semver_sort_cursor_less(heap[j + 1], heap[j])) {
+      j++;
+    }
+    if (!semver_sort_cursor_less(heap[j], c)) {
+      break;
+    }
+    heap[i] = heap[j];
+    i = j;
+  }
+  heap[i] = c;
+}
+
+/**
+ * semver_sort_merge_runs merges k sorted runs of file fd into w, run i
+ * being the range [bounds[i], bounds[i + 1]). With SEMVER_SORT_UNIQUE,
+ * versions equal to the previous one written are dropped. Adds the number
+ * of lines written to *n_out.
+ */
+int semver_sort_merge_runs(int fd, const off_t *bounds, size_t k,
+                           semver_sort_writer *w, int flags, size_t io_size,
+                           size_t *n_out) {
+  semver_sort_cursor *cursors;
+  semver_sort_cursor **heap;
+  semver_version_storage last_mem;
+  semver_version last = 0;
+  char *bufs;
+  size_t i, n = 0;
+  int res = SEMVER_OK;
+  int st;
+
+  cursors = semver_malloc(k * (sizeof(semver_sort_cursor) +
+                               sizeof(semver_sort_cursor *) + io_size));
+  if (!cursors) {
+    return SEMVER_ERROR_OUT_OF_MEMORY;
+  }
+  heap = (semver_sort_cursor **)(cursors + k);
+  bufs = (char *)(heap + k);
+
+  for (i = 0; i < k; i++) {
+    cursors[i].r.fd = fd;
+    cursors[i].r.buf = bufs + i * io_size;
+    cursors[i].r.size = io_size;
+    cursors[i].r.pos = cursors[i].r.len = 0;
+    cursors[i].r.eof = cursors[i].r.skip = 0;
+    cursors[i].r.off = bounds[i];
+    cursors[i].r.end = bounds[i + 1];
+    cursors[i].v = 0;
+    cursors[i].run = i;
+  }
+  for (i = 0; i < k; i++) {
+    st = semver_sort_cursor_next(&cursors[i]);
+    if (st < 0) {
+      res = st == -1 ? SEMVER_ERROR_IO : SEMVER_ERROR_OUT_OF_MEMORY;
+      goto out;
+    }
+    if (st > 0) {
+      heap[n++] = &cursors[i];
+    }
+  }
+  for (i = n / 2; i-- > 0;) {
+    semver_sort_heap_down(heap, n, i);
+  }
+
+  while (n > 0) {
+    if (!(flags & SEMVER_SORT_UNIQUE) || !last ||
+        semver_version_cmp(last, heap[0]->v) != 0) {
+      if (semver_sort_writer_put(w, heap[0]->v)) {
+        res = SEMVER_ERROR_IO;
+        goto out;
+      }
+      (*n_out)++;
+      if (flags & SEMVER_SORT_UNIQUE) {
+        if (last) {
+          semver_version_destroy(last);
+        }
+        last = semver_version_init_from_copy(&last_mem, heap[0]->v);
+        if (!last) {
+          res = SEMVER_ERROR_OUT_OF_MEMORY;
+          goto out;
+        }
+      }
+    }
+    st = semver_sort_cursor_next(heap[0]);
+    if (st < 0) {
+      res = st == -1 ? SEMVER_ERROR_IO : SEMVER_ERROR_OUT_OF_MEMORY;
+      goto out;
+    }
+    if (st == 0) {
+      heap[0] = heap[--n];
+    }
+    if (n > 0) {
+      semver_sort_heap_down(heap, n, 0);
+    }
+  }
+
+out:
+  for (i = 0; i < k; i++) {
+    if (cursors[i].v) {
+      semver_version_destroy(cursors[i].v);
+    }
+  }
+  if (last) {
+    semver_version_destroy(last);
+  }
+  semver_free(cursors);
+  return res;
+}
+
+/**
+ * semver_sort_fd_state is the state of semver_version_sort_fd: the run
+ * currently being collected in memory, and runs spilled to a file. All runs
+ * share one file, so the number of open files does not grow with the
+ * input: run i is the range [runs[i], runs[i + 1]) of runs_fd.
+ */
+typedef struct {
+  const semver_sort_fd_options *opts;
+  semver_arena arena;
+  semver_version *vs;
+  size_t n;
+  size_t cap;
+  int runs_fd;
+  off_t *runs;
+  size_t n_runs;
+  size_t cap_runs;
+  size_t io_size;
+} semver_sort_fd_state;
+
+/**
+ * semver_sort_fd_spill sorts the versions collected in memory and writes
+ * them to w, or appends them as a new run to the run file if w is NULL.
+ */
+int semver_sort_fd_spill(semver_sort_fd_state *st, semver_sort_writer *w,
+                         size_t *n_out) {
+  semver_sort_writer run;
+  semver_sort_rec *out;
+  void *block;
+  off_t *runs;
+  off_t end;
+  size_t i, u;
+  int res = SEMVER_OK;
+
+  if (st->n == 0 && !w) {
+    return SEMVER_OK;
+  }
+  u = semver_sort_run(st->vs, st->n, st->opts->flags, st->opts->n_threads,
+                      &out, &block);
+  if (u == (size_t)-1) {
+    return SEMVER_ERROR_OUT_OF_MEMORY;
+  }
+
+  if (!w) {
+    /* room for the bounds of one more run */
+    if (st->n_runs + 2 > st->cap_runs) {
+      runs = semver_realloc(st->runs, (2 * st->cap_runs + 8) * sizeof(off_t));
+      if (!runs) {
+        semver_free(block);
+        return SEMVER_ERROR_OUT_OF_MEMORY;
+      }
+      st->runs = runs;
+      st->cap_runs = 2 * st->cap_runs + 8;
+    }
+    if (st->runs_fd < 0) {
+      st->runs_fd = semver_sort_tmpfile(st->opts->tmp_dir);
+      if (st->runs_fd < 0) {
+        semver_free(block);
+        return SEMVER_ERROR_IO;
+      }
+      st->runs[0] = 0;
+    }
+    run.fd = st->runs_fd;
+    run.buf = semver_malloc(st->io_size);
+    run.size = st->io_size;
+    run.len = 0;
+    if (!run.buf) {
+      semver_free(block);
+      return SEMVER_ERROR_OUT_OF_MEMORY;
+    }
+  }
+
+  for (i = 0; i < u; i++) {
+    if (semver_sort_writer_put(w ? w : &run, st->vs[out[i].idx])) {
+      res = SEMVER_ERROR_IO;
+      break;
+    }
+  }
+  if (w) {
+    *n_out += i;
+  } else {
+    if (res == SEMVER_OK && semver_sort_writer_flush(&run)) {
+      res = SEMVER_ERROR_IO;
+    }
+    if (res == SEMVER_OK) {
+      /* runs are only appended to, reading them does not move the offset */
+      end = lseek(run.fd, 0, SEEK_CUR);
+      if (end < 0) {
+        res = SEMVER_ERROR_IO;
+      } else {
+        st->runs[++st->n_runs] = end;
+      }
+    }
+    semver_free(run.buf);
+  }
+  semver_free(block);
+
+  semver_arena_reset(st->arena);
+  st->n = 0;
+  return res;
+}
+
+/**
+ * semver_sort_fd_pass merges groups of SEMVER_SORT_FANIN runs into one run
+ * each, written to a new run file that replaces the current one. buf of
+ * given size is used for writing.
+ */
+int semver_sort_fd_pass(semver_sort_fd_state *st, char *buf, size_t size) {
+  semver_sort_writer run;
+  size_t i, j, m, merged = 0;
+  off_t end;
+  int res = SEMVER_OK;
+
+  run.fd = semver_sort_tmpfile(st->opts->tmp_dir);
+  if (run.fd < 0) {
+    return SEMVER_ERROR_IO;
+  }
+  run.buf = buf;
+  run.size = size;
+  run.len = 0;
+  for (i = 0, j = 0; i < st->n_runs && res == SEMVER_OK;
+       i += SEMVER_SORT_FANIN, j++) {
+    m = st->n_runs - i < SEMVER_SORT_FANIN ? st->n_runs - i
+                                           : SEMVER_SORT_FANIN;
+    res = semver_sort_merge_runs(st->runs_fd, st->runs + i, m, &run,
+                                 st->opts->flags, st->io_size, &merged);
+    if (res == SEMVER_OK && semver_sort_writer_flush(&run)) {
+      res = SEMVER_ERROR_IO;
+    }
+    if (res == SEMVER_OK) {
+      end = lseek(run.fd, 0, SEEK_CUR);
+      if (end < 0) {
+        res = SEMVER_ERROR_IO;
+      }
+      /* j + 1 <= i + m, the bounds of the runs merged have been read */
+      st->runs[j + 1] = end;
+    }
+  }
+  if (res != SEMVER_OK) {
+    close(run.fd);
+    return res;
+  }
+  close(st->runs_fd);
+  st->runs_fd = run.fd;
+  st->n_runs = j;
+  return SEMVER_OK;
+}
+
+/**
+ * semver_sort_fd_memory estimates the memory used by the current run,
+ * including what is needed to sort it.
+ */
+size_t semver_sort_fd_memory(const semver_sort_fd_state *st) {
+  return semver_arena_used(st->arena) + st->cap * sizeof(semver_version) +
+         (2 * st->n + 1) * sizeof(semver_sort_rec);
+}
+
+int semver_version_sort_fd(int in_fd, int out_fd,
+                           const semver_sort_fd_options *opts,
+                           size_t *n_out) {
+  semver_sort_fd_options defaults;
+  semver_sort_fd_state st;
+  semver_sort_reader r;
+  semver_sort_writer w;
+  semver_version_wrapped v;
+  semver_version *vs;
+  const char *line;
+  size_t n, i, j, budget, count = 0;
+  int k, res = SEMVER_OK;
+
+  memset(&defaults, 0, sizeof(defaults));
+  if (opts) {
+    defaults = *opts;
+  }
+  if (!defaults.tmp_dir) {
+    defaults.tmp_dir = getenv("TMPDIR") ? getenv("TMPDIR") : "/tmp";
+  }
+  budget = defaults.mem_budget ? defaults.mem_budget
+                               : SEMVER_SORT_DEFAULT_BUDGET;
+  if (n_out) {
+    *n_out = 0;
+  }
+
+  memset(&st, 0, sizeof(st));
+  st.opts = &defaults;
+  st.runs_fd = -1;
+  /* I/O buffers of a merge take a share of the budget */
+  st.io_size = budget / (4 * (SEMVER_SORT_FANIN + 1));
+  st.io_size = st.io_size < SEMVER_SORT_IO_MIN   ? SEMVER_SORT_IO_MIN
+               : st.io_size > SEMVER_SORT_IO_MAX ? SEMVER_SORT_IO_MAX
+                                                 : st.io_size;
+  st.arena = semver_arena_new(0);
+  r.buf = semver_malloc(st.io_size);
+  w.buf = semver_malloc(st.io_size);
+  if (!st.arena || !r.buf || !w.buf) {
+    res = SEMVER_ERROR_OUT_OF_MEMORY;
+    goto out;
+  }
+  r.fd = in_fd;
+  r.size = st.io_size;
+  r.pos = r.len = 0;
+  r.eof = r.skip = 0;
+  r.off = 0;
+  r.end = -1;
+  w.fd = out_fd;
+  w.size = st.io_size;
+  w.len = 0;
+
+  while ((k = semver_sort_reader_line(&r, &line, &n)) > 0) {
+    if (n == SEMVER_SORT_OVERLONG) {
+      continue;
+    }
+    if (n > 0 && line[n - 1] == '\r') {
+      n--;
+    }
+    if (n == 0) {
+      continue;
+    }
+    v = semver_version_from_strn_wrapped_in(st.arena, line, n);
+    if (v.err) {
+      if (v.unwrap.code == SEMVER_ERROR_OUT_OF_MEMORY) {
+        res = SEMVER_ERROR_OUT_OF_MEMORY;
+        goto out;
+      }
+      continue;
+    }
+    if (st.n == st.cap) {
+      vs = semver_realloc(st.vs, (2 * st.cap + 64) * sizeof(semver_version));
+      if (!vs) {
+        res = SEMVER_ERROR_OUT_OF_MEMORY;
+        goto out;
+      }
+      st.vs = vs;
+      st.cap = 2 * st.cap + 64;
+    }
+    st.vs[st.n++] = v.unwrap.result;
+    if (semver_sort_fd_memory(&st) >= budget) {
+      res = semver_sort_fd_spill(&st, 0, 0);
+      if (res != SEMVER_OK) {
+        goto out;
+      }
+    }
+  }
+  if (k < 0) {
+    res = SEMVER_ERROR_IO;
+    goto out;
+  }
+
+  if (st.n_runs == 0) {
+    /* everything fit into memory */
+    res = semver_sort_fd_spill(&st, &w, &count);
+  } else {
+    res = semver_sort_fd_spill(&st, 0, 0);
+    /* release the collected run before merging */
+    semver_free(st.vs);
+    st.vs = 0;
+    st.cap = 0;
+    semver_arena_delete(st.arena);
+    st.arena = 0;
+
+    /* merge groups of runs into larger ones until a single pass is left */
+    while (res == SEMVER_OK && st.n_runs > SEMVER_SORT_FANIN) {
+      res = semver_sort_fd_pass(&st, w.buf, w.size);
+    }
+    if (res == SEMVER_OK) {
+      res = semver_sort_merge_runs(st.runs_fd, st.runs, st.n_runs, &w,
+                                   defaults.flags, st.io_size, &count);
+    }
+  }
+  if (res == SEMVER_OK && semver_sort_writer_flush(&w)) {
+    res = SEMVER_ERROR_IO;
+  }
+  if (n_out) {
+    *n_out = count;
+  }
+
+out:
+  if (st.runs_fd >= 0) {
+    close(st.runs_fd);
+  }
+  semver_free(st.runs);
+  semver_free(st.vs);
+  semver_arena_delete(st.arena);
+  semver_free(r.buf);
+  semver_free(w.buf);
+  return res;
+}
@@ -3,6 +3,18 @@
 
 extern void run_semver_tests(void);
 extern void run_semverreq_tests(void);
+extern void run_semverarena_tests(void);
+extern void run_semverbatch_tests(void);
+extern void run_semvercollate_tests(void);
+extern void run_semverscan_tests(void);
+extern void run_semversort_tests(void);
+extern void run_semversortfd_tests(void);
+extern void run_semverintern_tests(void);
+extern void run_semverordinal_tests(void);
+extern void run_semvermatrix_tests(void);
+extern void run_semverreqindex_tests(void);
+extern void run_semvercatalog_tests(void);
+extern void run_semvercatfile_tests(void);
 
 void setUp(void) {}
 
@@ -13,6 +25,18 @@ int main(void) {
 
   run_semver_tests();
   run_semverreq_tests();
+  run_semverarena_tests();
+  run_semverbatch_tests();
+  run_semvercollate_tests();
+  run_semverscan_tests();
+  run_semversort_tests();
+  run_semversortfd_tests();
+  run_semverintern_tests();
+  run_semverordinal_tests();
+  run_semvermatrix_tests();
+  run_semverreqindex_tests();
+  run_semvercatalog_tests();
+  run_semvercatfile_tests();
 
   return UNITY_END();
 }
@@ -1,3 +1,5 @@
+#include <limits.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -51,6 +53,13 @@ void test_semver_invalid_parsing(void) {
       {"1.2.03", SEMVER_ERROR_PARSE_NOT_ALLOWED_HERE},
       {"1.2.3-we%rd+stuff", SEMVER_ERROR_PARSE_NOT_ALLOWED_HERE},
       {"1.2.3-weird+st$ff", SEMVER_ERROR_PARSE_NOT_ALLOWED_HERE},
+      {".2.3", SEMVER_ERROR_PARSE_NOT_ALLOWED_HERE},
+      {"1..3", SEMVER_ERROR_PARSE_NOT_ALLOWED_HERE},
+      {"1.2.-rc", SEMVER_ERROR_PARSE_NOT_ALLOWED_HERE},
+      {"1.2.3.4", SEMVER_ERROR_PARSE_NOT_ALLOWED_HERE},
+      {"00.1.2", SEMVER_ERROR_PARSE_NOT_ALLOWED_HERE},
+      {"99999999999999999999999.0.0", SEMVER_ERROR_PARSE_OVERFLOW},
+      {"1.2.99999999999999999999999-rc", SEMVER_ERROR_PARSE_OVERFLOW},
   };
 
   size_t i;
@@ -75,6 +84,33 @@ void test_semver_invalid_parsing(void) {
   }
 }
 
+void test_semver_parse_limits(void) {
+  char buf[SEMVER_MAXLEN];
+  semver_version_wrapped w;
+  semver_version v;
+
+  /* largest representable components */
+  sprintf(buf, "%lu.%lu.%lu", ULONG_MAX, ULONG_MAX - 1, ULONG_MAX);
+  v = semver_version_from_string(buf);
+  TEST_ASSERT_NOT_NULL(v);
+  TEST_ASSERT_TRUE(semver_version_get_major(v) == ULONG_MAX);
+  TEST_ASSERT_TRUE(semver_version_get_minor(v) == ULONG_MAX - 1);
+  TEST_ASSERT_TRUE(semver_version_get_patch(v) == ULONG_MAX);
+  semver_version_delete(v);
+
+  /* one more overflows */
+  sprintf(buf, "1.%lu0.0", ULONG_MAX / 10 + 1);
+  w = semver_version_from_string_wrapped(buf);
+  TEST_ASSERT_TRUE(w.err);
+  TEST_ASSERT_EQUAL(SEMVER_ERROR_PARSE_OVERFLOW, w.unwrap.code);
+
+  sprintf(buf, "1.0.%lu", ULONG_MAX);
+  buf[strlen(buf) - 1]++;
+  w = semver_version_from_string_wrapped(buf);
+  TEST_ASSERT_TRUE(w.err);
+  TEST_ASSERT_EQUAL(SEMVER_ERROR_PARSE_OVERFLOW, w.unwrap.code);
+}
+
 void test_semver_valid_parsing(void) {
   const char *inp[] = {"0.0.0",
                        "0.0.1",
@@ -169,6 +205,12 @@ void test_semver_formatting(void) {
 #endif
     TEST_ASSERT_EQUAL_STRING(inp[i], buf);
 
+    /* parsing again into the same struct replaces its contents */
+    res = semver_version_from_string_impl(s1, "1.0.0-rc.1+reparsed");
+    TEST_ASSERT_EQUAL(res, SEMVER_OK);
+    semver_version_sprint(s1, buf);
+    TEST_ASSERT_EQUAL_STRING("1.0.0-rc.1+reparsed", buf);
+
     semver_version_delete(s1);
   }
 }
@@ -214,6 +256,10 @@ void test_semver_cmp(void) {
       {"1.1.2-alpha.1", "1.1.1-alpha.1", 3},
       {"1.1.2-alpha.1", "1.1.2-alpha.2", -2},
       {"1.1.2-alpha.1", "1.1.2-alpha.1.longer", -2},
+      {"1.1.2-alpha.9", "1.1.2-alpha.10", -2},
+      {"1.1.2-alpha.10", "1.1.2-alpha.beta", -2},
+      {"1.1.2-rc.99999999999999999999", "1.1.2-rc.100000000000000000000", -2},
+      {"1.1.2-rc.1+build.2", "1.1.2-rc.1+build.1", 0},
   };
 
   size_t i;
@@ -276,6 +322,11 @@ void test_semver_prerelease_cmp(void) {
       {"alpha.1.2", "alpha.1.10", -3},
       {"alpha.1.10", "alpha.1.11", -3},
       {"alpha.1.10", "alpha.1.10.some", -4},
+      {"alpha.1", "alpha.beta", -2},    /* numeric < alphanumeric */
+      {"1", "-1", -1},
+      {"beta.2", "beta.11", -2},
+      {"rc.9", "rc.12345678901234567890123", -2}, /* no length limit */
+      {"alpha", "alpha-1", -1},
       {"", "", 0}, /* empty strings are considered equal too */
   };
 
@@ -293,6 +344,9 @@ void test_semver_prerelease_cmp(void) {
 void test_semver_copy(void) {
   const exp_t tests[] = {
     { "1.2.3", 0 },
+    { "1.2.3-alpha.1", 0 },
+    { "1.2.3+build.5", 0 },
+    { "1.2.3-alpha.1+build.5", 0 },
   };
   size_t i;
   char buf[SEMVER_MAXLEN];
@@ -379,12 +433,310 @@ void test_semver_cmp3_invalid(void) {
   TEST_ASSERT_NOT_EQUAL(0, r);
 }
 
+void test_semver_hash(void) {
+  const exp4_t tests[] = {
+      /* equal precedence, equal hash */
+      {"1.2.3", "1.2.3+build.1", 0},
+      {"1.2.3-rc.01", "1.2.3-rc.1", 0},
+      {"1.2.3-00000000000000000000099", "1.2.3-99", 0},
+      {"1.2.3-x.0099999999999999999999", "1.2.3-x.99999999999999999999", 0},
+      {"1.2.3-", "1.2.3", 0},
+      /* different precedence */
+      {"1.2.3", "1.2.4", 1},
+      {"1.2.3", "3.2.1", 1},
+      {"1.2.3-rc.1", "1.2.3-rc1", 1},
+      {"1.2.3-1", "1.2.3-a", 1},
+      {"1.2.3-rc.1", "1.2.3", 1},
+      {"1.2.3-alpha.beta", "1.2.3-alphab.eta", 1},
+      {"1.2.3-abcdefghijklmnop", "1.2.3-abcdefghijklmnoq", 1},
+  };
+  semver_version a, b;
+  size_t i;
+
+  for (i = 0; i < sizeof(tests) / sizeof(exp4_t); i++) {
+    a = semver_version_from_string(tests[i].inp_a);
+    b = semver_version_from_string(tests[i].inp_b);
+    TEST_ASSERT_NOT_NULL(a);
+    TEST_ASSERT_NOT_NULL(b);
+    TEST_ASSERT_EQUAL(tests[i].exp_res, semver_version_cmp(a, b) != 0);
+    TEST_ASSERT_EQUAL(tests[i].exp_res,
+                      semver_version_hash(a) != semver_version_hash(b));
+    semver_version_delete(a);
+    semver_version_delete(b);
+  }
+
+  a = semver_version_from_string("1.2.3+build.1");
+  b = semver_version_from_string("1.2.3+build.2");
+  TEST_ASSERT_TRUE(semver_version_hash(a) == semver_version_hash(b));
+  TEST_ASSERT_TRUE(semver_version_hash_exact(a) != semver_version_hash_exact(b));
+  semver_version_delete(b);
+  b = semver_version_from_string("1.2.3+build.1");
+  TEST_ASSERT_TRUE(semver_version_hash_exact(a) == semver_version_hash_exact(b));
+  semver_version_delete(b);
+  b = semver_version_from_string("1.2.3+");
+  TEST_ASSERT_TRUE(semver_version_hash_exact(a) != semver_version_hash_exact(b));
+  semver_version_delete(a);
+  a = semver_version_from_string("1.2.3");
+  TEST_ASSERT_TRUE(semver_version_hash_exact(a) != semver_version_hash_exact(b));
+  semver_version_delete(a);
+  semver_version_delete(b);
+}
+
+void test_semver_key(void) {
+  const char *inp[] = {
+      "0.0.0-alpha", "0.0.0", "0.0.1", "0.1.0-rc.1", "0.1.0-rc.2", "0.1.0",
+      "1.0.0-", "1.0.0", "1.0.0+build", "1.2.3", "1.2.32766", "1.2.32767-rc",
+      "1.2.32767", "1.2.65536", "1.65534.7", "1.65535.0", "1.65536.0-rc",
+#if ULONG_MAX > 0xffffffffUL
+      /* beyond the packed fields of 64-bit keys */
+      "1.65536.2147483646", "1.65536.2147483647-rc", "1.65536.2147483647",
+      "1.65536.4294967296", "1.4294967294.7", "1.4294967295.0",
+      "1.4294967296.0-rc", "4294967296.0.0", "18446744073709551615.0.0",
+#endif
+      "2.0.0",
+  };
+  const size_t n = sizeof(inp) / sizeof(const char *);
+  semver_version v[sizeof(inp) / sizeof(const char *)];
+  semver_version_key k[sizeof(inp) / sizeof(const char *)];
+  size_t i, j;
+  int c, kc;
+
+  for (i = 0; i < n; i++) {
+    v[i] = semver_version_from_string(inp[i]);
+    TEST_ASSERT_NOT_NULL(v[i]);
+    k[i] = semver_version_key_of(v[i]);
+  }
+  for (i = 0; i < n; i++) {
+    for (j = 0; j < n; j++) {
+      c = semver_version_cmp(v[i], v[j]);
+      kc = semver_version_key_cmp(&k[i], &k[j]);
+      /* keys never contradict the full comparison */
+      TEST_ASSERT_TRUE(kc == 0 || (kc < 0) == (c < 0));
+      c = (c > 0) - (c < 0);
+      kc = semver_version_cmp_keyed(v[i], &k[i], v[j], &k[j]);
+      kc = (kc > 0) - (kc < 0);
+      TEST_ASSERT_EQUAL(c, kc);
+    }
+  }
+  /* only prerelease decides, keys tie */
+  TEST_ASSERT_EQUAL(0, semver_version_key_cmp(&k[3], &k[4]));
+  /* release bit */
+  TEST_ASSERT_EQUAL(-1, semver_version_key_cmp(&k[4], &k[5]));
+  TEST_ASSERT_EQUAL(0, semver_version_key_cmp(&k[6], &k[7]));
+
+  for (i = 0; i < n; i++) {
+    semver_version_delete(v[i]);
+  }
+}
+
+void test_semver_strn(void) {
+  /* slices of a larger buffer, not NUL-terminated */
+  const char buf[] = "1.2.3-rc.1+b5 10.20.30\n0.0.1";
+  const char nul[] = "1.2.3\0-rc.1";
+  semver_version_storage mem;
+  semver_version_wrapped w;
+  semver_version v;
+  char out[SEMVER_MAXLEN];
+
+  v = semver_version_from_strn(buf, 13);
+  TEST_ASSERT_NOT_NULL(v);
+  semver_version_sprint(v, out);
+  TEST_ASSERT_EQUAL_STRING("1.2.3-rc.1+b5", out);
+  semver_version_delete(v);
+
+  v = semver_version_from_strn(buf, 10);
+  TEST_ASSERT_NOT_NULL(v);
+  semver_version_sprint(v, out);
+  TEST_ASSERT_EQUAL_STRING("1.2.3-rc.1", out);
+  semver_version_delete(v);
+
+  v = semver_version_init_from_strn(&mem, buf + 14, 8);
+  TEST_ASSERT_NOT_NULL(v);
+  TEST_ASSERT_EQUAL(10, semver_version_get_major(v));
+  TEST_ASSERT_EQUAL(30, semver_version_get_patch(v));
+  semver_version_destroy(v);
+
+  v = semver_version_init_from_strn(&mem, buf + 23, 5);
+  TEST_ASSERT_NOT_NULL(v);
+  TEST_ASSERT_EQUAL(1, semver_version_get_patch(v));
+  semver_version_destroy(v);
+
+  /* slice ends in the middle of a version */
+  w = semver_version_from_strn_wrapped(buf, 4);
+  TEST_ASSERT_EQUAL(1, w.err);
+  TEST_ASSERT_EQUAL(SEMVER_ERROR_PARSE_PREMATURE_EOS, w.unwrap.code);
+  w = semver_version_from_strn_wrapped(buf, 0);
+  TEST_ASSERT_EQUAL(1, w.err);
+
+  /* a slice spanning the separator is invalid */
+  w = semver_version_from_strn_wrapped(buf, 15);
+  TEST_ASSERT_EQUAL(1, w.err);
+  TEST_ASSERT_EQUAL(SEMVER_ERROR_PARSE_NOT_ALLOWED_HERE, w.unwrap.code);
+
+  /* embedded NUL within len is rejected */
+  w = semver_version_init_from_strn_wrapped(&mem, nul, sizeof(nul) - 1);
+  TEST_ASSERT_EQUAL(1, w.err);
+  TEST_ASSERT_EQUAL(SEMVER_ERROR_PARSE_NOT_ALLOWED_HERE, w.unwrap.code);
+  v = semver_version_init_from_strn(&mem, nul, 5);
+  TEST_ASSERT_NOT_NULL(v);
+  semver_version_destroy(v);
+}
+
+void test_semver_storage(void) {
+  const char *inp[] = {
+      "1.2.3",
+      "1.0.0-rc.1",
+      "1.0.0-alpha.beta.1+build.123",
+      /* does not fit into storage, spills into a separate block */
+      "1.0.0-alpha.1.2.3.4.5.6.7.8.9.10.11.12+sha.4f1b2c3d4e5f60718293a4b5c6d7e8f9"
+  };
+  const size_t n = sizeof(inp) / sizeof(const char *);
+  semver_version_storage arr[4];
+  semver_version_storage moved;
+  semver_version_wrapped w;
+  semver_version v, h;
+  char buf[SEMVER_MAXLEN];
+  size_t i;
+
+  TEST_ASSERT_EQUAL(0, ((size_t)&arr[1]) % SEMVER_STORAGE_ALIGN);
+
+  for (i = 0; i < n; i++) {
+    v = semver_version_init_from_string(&arr[i], inp[i]);
+    TEST_ASSERT_NOT_NULL(v);
+    TEST_ASSERT_EQUAL_PTR(&arr[i], v);
+
+    semver_version_sprint(v, buf);
+    TEST_ASSERT_EQUAL_STRING(inp[i], buf);
+
+    /* must compare the same as a heap allocated version */
+    h = semver_version_from_string(inp[i]);
+    TEST_ASSERT_EQUAL(0, semver_version_cmp(v, h));
+    semver_version_delete(h);
+  }
+  TEST_ASSERT_LESS_THAN(0, semver_version_cmp((semver_version)&arr[2],
+                                              (semver_version)&arr[1]));
+
+  /* storage may be moved */
+  for (i = 0; i < n; i++) {
+    memcpy(&moved, &arr[i], sizeof(moved));
+    semver_version_sprint((semver_version)&moved, buf);
+    TEST_ASSERT_EQUAL_STRING(inp[i], buf);
+    semver_version_destroy((semver_version)&moved);
+  }
+
+  v = semver_version_init_from(&arr[0], 1, 2, 3, "alpha", "b1");
+  semver_version_sprint(v, buf);
+  TEST_ASSERT_EQUAL_STRING("1.2.3-alpha+b1", buf);
+  h = semver_version_init_from_copy(&arr[1], v);
+  TEST_ASSERT_EQUAL(0, semver_version_cmp(v, h));
+  /* delete does not free caller-provided storage */
+  semver_version_delete(v);
+  semver_version_destroy(h);
+
+  w = semver_version_init_from_string_wrapped(&arr[0], "1.2");
+  TEST_ASSERT_TRUE(w.err);
+  TEST_ASSERT_EQUAL(SEMVER_ERROR_PARSE_PREMATURE_EOS, w.unwrap.code);
+  TEST_ASSERT_NULL(semver_version_init_from_string(&arr[0], "x.y.z"));
+}
+
+typedef struct {
+  size_t mallocs;
+  size_t frees;
+  int fail;
+} counting_allocator_t;
+
+void *counting_malloc(void *user, size_t size) {
+  counting_allocator_t *c = (counting_allocator_t *)user;
+  if (c->fail) {
+    return 0;
+  }
+  c->mallocs++;
+  return malloc(size);
+}
+
+void *counting_realloc(void *user, void *ptr, size_t size) {
+  counting_allocator_t *c = (counting_allocator_t *)user;
+  if (c->fail) {
+    return 0;
+  }
+  if (!ptr) {
+    c->mallocs++;
+  }
+  return realloc(ptr, size);
+}
+
+void counting_free(void *user, void *ptr) {
+  counting_allocator_t *c = (counting_allocator_t *)user;
+  c->frees++;
+  free(ptr);
+}
+
+void test_semver_allocator(void) {
+  counting_allocator_t c = {0, 0, 0};
+  semver_allocator a;
+  semver_allocator prev;
+  semver_version_storage mem;
+  semver_version v, w;
+  semver_version_wrapped wr;
+  int res;
+
+  a.malloc_fn = counting_malloc;
+  a.realloc_fn = counting_realloc;
+  a.free_fn = counting_free;
+  a.user = &c;
+  semver_get_allocator(&prev);
+  semver_set_allocator(&a);
+
+  /* a version is a single block */
+  v = semver_version_from_string("1.0.0-rc.1+build.5");
+  TEST_ASSERT_NOT_NULL(v);
+  TEST_ASSERT_EQUAL(1, c.mallocs);
+  w = semver_version_from_copy(v);
+  TEST_ASSERT_EQUAL(2, c.mallocs);
+  semver_version_delete(w);
+  semver_version_delete(v);
+  TEST_ASSERT_EQUAL(2, c.frees);
+
+  v = semver_version_from(1, 2, 3, "alpha", "build");
+  TEST_ASSERT_EQUAL(3, c.mallocs);
+  semver_version_delete(v);
+  TEST_ASSERT_EQUAL(3, c.frees);
+
+  /* no allocation for caller-provided storage */
+  v = semver_version_init_from_string(&mem, "1.0.0-rc.1+build.5");
+  semver_version_destroy(v);
+  TEST_ASSERT_EQUAL(0, semver_cmp("1.0.0-rc.1", "1.0.0-rc.2", &res));
+  TEST_ASSERT_EQUAL(3, c.mallocs);
+  TEST_ASSERT_EQUAL(3, c.frees);
+
+  /* out of memory */
+  c.fail = 1;
+  TEST_ASSERT_NULL(semver_version_from_string("1.2.3"));
+  wr = semver_version_from_string_wrapped("1.2.3");
+  TEST_ASSERT_TRUE(wr.err);
+  TEST_ASSERT_EQUAL(SEMVER_ERROR_OUT_OF_MEMORY, wr.unwrap.code);
+  /* invalid input is still reported as such */
+  wr = semver_version_from_string_wrapped("1.2");
+  TEST_ASSERT_EQUAL(SEMVER_ERROR_PARSE_PREMATURE_EOS, wr.unwrap.code);
+  TEST_ASSERT_NULL(semver_version_new());
+
+  semver_set_allocator(&prev);
+
+  /* NULL restores the default */
+  semver_set_allocator(0);
+  v = semver_version_from_string("1.2.3");
+  TEST_ASSERT_NOT_NULL(v);
+  semver_version_delete(v);
+  TEST_ASSERT_EQUAL(3, c.mallocs);
+}
+
 void run_semver_tests(void) {
   int i;
   for (i = 0; i < 1; i++) {
     RUN_TEST(test_semver_formatting);
     RUN_TEST(test_semver_valid_parsing);
     RUN_TEST(test_semver_invalid_parsing);
+    RUN_TEST(test_semver_parse_limits);
     RUN_TEST(test_semver_constructing);
     RUN_TEST(test_semver_cmp);
     RUN_TEST(test_semver_cmp2);
@@ -392,5 +744,10 @@ void run_semver_tests(void) {
     RUN_TEST(test_semver_copy);
     RUN_TEST(test_semver_cmp3);
     RUN_TEST(test_semver_cmp3_invalid);
+    RUN_TEST(test_semver_hash);
+    RUN_TEST(test_semver_key);
+    RUN_TEST(test_semver_strn);
+    RUN_TEST(test_semver_storage);
+    RUN_TEST(test_semver_allocator);
   }
 }
@@ -0,0 +1,174 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "semver.h"
+#include "semverreq.h"
+#include "semverarena.h"
+
+#include "unity.h"
+
+void test_semverarena_alloc(void) {
+  semver_arena a;
+  char *p, *q, *big;
+  size_t i;
+
+  a = semver_arena_new(256);
+  TEST_ASSERT_NOT_NULL(a);
+  TEST_ASSERT_EQUAL(0, semver_arena_used(a));
+
+  p = semver_arena_alloc(a, 3);
+  q = semver_arena_alloc(a, 5);
+  TEST_ASSERT_NOT_NULL(p);
+  TEST_ASSERT_NOT_NULL(q);
+  TEST_ASSERT_EQUAL(0, ((size_t)p) % SEMVER_STORAGE_ALIGN);
+  TEST_ASSERT_EQUAL(0, ((size_t)q) % SEMVER_STORAGE_ALIGN);
+  TEST_ASSERT_TRUE(q >= p + 3);
+
+  /* larger than a block */
+  big = semver_arena_alloc(a, 4096);
+  TEST_ASSERT_NOT_NULL(big);
+  memset(big, 0xAB, 4096);
+
+  /* sizes that would wrap around when rounded */
+  i = semver_arena_used(a);
+  TEST_ASSERT_NULL(semver_arena_alloc(a, (size_t)-1));
+  TEST_ASSERT_NULL(semver_arena_alloc(a, (size_t)-1 - SEMVER_STORAGE_ALIGN));
+  TEST_ASSERT_EQUAL(i, semver_arena_used(a));
+
+  /* many small ones across several blocks */
+  for (i = 0; i < 1000; i++) {
+    p = semver_arena_alloc(a, 24);
+    TEST_ASSERT_NOT_NULL(p);
+    memset(p, 0, 24);
+  }
+  TEST_ASSERT_GREATER_OR_EQUAL(4096 + 1000 * 24, semver_arena_used(a));
+
+  semver_arena_reset(a);
+  TEST_ASSERT_EQUAL(0, semver_arena_used(a));
+  p = semver_arena_alloc(a, 100);
+  TEST_ASSERT_NOT_NULL(p);
+
+  semver_arena_delete(a);
+}
+
+void test_semverarena_versions(void) {
+  const char *inp[] = {"1.2.3", "1.0.0-rc.1", "1.0.0-alpha.beta.1+build.123",
+                       "0.0.1+b"};
+  const size_t n = sizeof(inp) / sizeof(const char *);
+  semver_arena a = semver_arena_new(0);
+  semver_version v[4];
+  semver_version w;
+  semver_version_wrapped wr;
+  char buf[SEMVER_MAXLEN];
+  size_t i;
+
+  for (i = 0; i < n; i++) {
+    v[i] = semver_version_from_string_in(a, inp[i]);
+    TEST_ASSERT_NOT_NULL(v[i]);
+    semver_version_sprint(v[i], buf);
+    TEST_ASSERT_EQUAL_STRING(inp[i], buf);
+
+    w = semver_version_from_copy_in(a, v[i]);
+    TEST_ASSERT_EQUAL(0, semver_version_cmp(v[i], w));
+
+    /* no-op for arena objects */
+    semver_version_delete(w);
+  }
+  TEST_ASSERT_LESS_THAN(0, semver_version_cmp(v[1], v[0]));
+
+  w = semver_version_from_in(a, 4, 5, 6, "pre", "build");
+  semver_version_sprint(w, buf);
+  TEST_ASSERT_EQUAL_STRING("4.5.6-pre+build", buf);
+
+  TEST_ASSERT_NULL(semver_version_from_string_in(a, "1.x.2"));
+  wr = semver_version_from_string_wrapped_in(a, "1.2");
+  TEST_ASSERT_TRUE(wr.err);
+  TEST_ASSERT_EQUAL(SEMVER_ERROR_PARSE_PREMATURE_EOS, wr.unwrap.code);
+
+  semver_arena_delete(a);
+}
+
+void test_semverarena_reqs(void) {
+  semver_arena a = semver_arena_new(1024);
+  semver_version_req r, q;
+  semver_version v;
+  semver_version_req_wrapped w;
+  char buf[SEMVERREQ_MAXLEN];
+  size_t i;
+
+  for (i = 0; i < 100; i++) {
+    r = semver_version_req_from_string_in(a, ">=1.2.0-alpha.1+build <2.0.0");
+    TEST_ASSERT_NOT_NULL(r);
+  }
+  semver_version_req_sprint(r, buf);
+  TEST_ASSERT_EQUAL_STRING(">=1.2.0-alpha.1+build <2.0.0", buf);
+
+  v = semver_version_from_string_in(a, "1.5.0");
+  TEST_ASSERT_EQUAL(1, semver_version_req_matches(r, v));
+
+  r = semver_version_req_from_string_in(a, "^1.4.0");
+  TEST_ASSERT_EQUAL(1, semver_version_req_matches(r, v));
+
+  q = semver_version_req_from_in(a, v, 1, 0, 0);
+  semver_version_req_sprint(q, buf);
+  TEST_ASSERT_EQUAL_STRING(">=1.5.0", buf);
+  /* no-op for arena objects */
+  semver_version_req_delete(q);
+
+  w = semver_version_req_from_string_wrapped_in(a, "~x.1.0");
+  TEST_ASSERT_TRUE(w.err);
+  TEST_ASSERT_EQUAL(SEMVERREQ_INVALID_SEMVER, w.unwrap.code);
+
+  semver_arena_reset(a);
+  r = semver_version_req_from_string_in(a, "=1.0.0");
+  TEST_ASSERT_NOT_NULL(r);
+
+  semver_arena_delete(a);
+}
+
+typedef struct {
+  size_t mallocs;
+  size_t frees;
+} arena_counter_t;
+
+void *arena_counting_malloc(void *user, size_t size) {
+  ((arena_counter_t *)user)->mallocs++;
+  return malloc(size);
+}
+
+void *arena_counting_realloc(void *user, void *ptr, size_t size) {
+  return realloc(ptr, size);
+}
+
+void arena_counting_free(void *user, void *ptr) {
+  ((arena_counter_t *)user)->frees++;
+  free(ptr);
+}
+
+void test_semverarena_allocator(void) {
+  arena_counter_t c = {0, 0};
+  semver_allocator al;
+  semver_arena a;
+  size_t i;
+
+  al.malloc_fn = arena_counting_malloc;
+  al.realloc_fn = arena_counting_realloc;
+  al.free_fn = arena_counting_free;
+  al.user = &c;
+
+  a = semver_arena_new_with(&al, 4096);
+  for (i = 0; i < 1000; i++) {
+    TEST_ASSERT_NOT_NULL(semver_version_from_string_in(a, "1.2.3-beta.1"));
+  }
+  /* arena itself plus a few blocks, not one per version */
+  TEST_ASSERT_LESS_THAN(50, c.mallocs);
+  semver_arena_delete(a);
+  TEST_ASSERT_EQUAL(c.mallocs, c.frees);
+}
+
+void run_semverarena_tests(void) {
+  RUN_TEST(test_semverarena_alloc);
+  RUN_TEST(test_semverarena_versions);
+  RUN_TEST(test_semverarena_reqs);
+  RUN_TEST(test_semverarena_allocator);
+}
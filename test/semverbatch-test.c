@@ -0,0 +1,112 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "semver.h"
+#include "semverbatch.h"
+
+#include "unity.h"
+
+void test_semverbatch_parse(void) {
+  const char *inp[] = {
+      "1.2.3",
+      "1.0.0-rc.1+build.5",
+      "a.b.c",
+      "2.0.0+sha.1",
+      "1.2.3-",
+      "01.2.3",
+  };
+  const size_t n = sizeof(inp) / sizeof(const char *);
+  semver_version_batch b;
+  semver_version_storage mem;
+  semver_version v, h;
+  char buf[SEMVER_MAXLEN];
+  size_t i;
+
+  TEST_ASSERT_EQUAL(SEMVER_OK, semver_version_batch_parse(&b, inp, NULL, n));
+  TEST_ASSERT_EQUAL(n, b.n);
+  TEST_ASSERT_EQUAL(4, b.n_ok);
+
+  TEST_ASSERT_EQUAL(SEMVER_OK, b.err[0]);
+  TEST_ASSERT_EQUAL(1, b.major[0]);
+  TEST_ASSERT_EQUAL(2, b.minor[0]);
+  TEST_ASSERT_EQUAL(3, b.patch[0]);
+  TEST_ASSERT_NULL(semver_version_batch_prerelease(&b, 0));
+  TEST_ASSERT_NULL(semver_version_batch_build(&b, 0));
+
+  TEST_ASSERT_EQUAL_STRING("rc.1", semver_version_batch_prerelease(&b, 1));
+  TEST_ASSERT_EQUAL_STRING("build.5", semver_version_batch_build(&b, 1));
+
+  TEST_ASSERT_EQUAL(SEMVER_ERROR_PARSE_NOT_ALLOWED_HERE, b.err[2]);
+  TEST_ASSERT_EQUAL(0, b.major[2]);
+  TEST_ASSERT_EQUAL(SEMVER_BATCH_NONE, b.prerelease_off[2]);
+  TEST_ASSERT_NULL(semver_version_batch_init_version(&b, 2, &mem));
+
+  TEST_ASSERT_NULL(semver_version_batch_prerelease(&b, 3));
+  TEST_ASSERT_EQUAL_STRING("sha.1", semver_version_batch_build(&b, 3));
+
+  /* empty prerelease is kept apart from an absent one */
+  TEST_ASSERT_EQUAL_STRING("", semver_version_batch_prerelease(&b, 4));
+  TEST_ASSERT_EQUAL(SEMVER_ERROR_PARSE_NOT_ALLOWED_HERE, b.err[5]);
+
+  /* items convert back into versions equal to individually parsed ones */
+  for (i = 0; i < n; i++) {
+    if (b.err[i] != SEMVER_OK) {
+      continue;
+    }
+    v = semver_version_batch_init_version(&b, i, &mem);
+    TEST_ASSERT_NOT_NULL(v);
+    semver_version_sprint(v, buf);
+    TEST_ASSERT_EQUAL_STRING(inp[i], buf);
+    h = semver_version_from_string(inp[i]);
+    TEST_ASSERT_EQUAL(0, semver_version_cmp(v, h));
+    semver_version_delete(h);
+    semver_version_destroy(v);
+  }
+
+  semver_version_batch_destroy(&b);
+  TEST_ASSERT_EQUAL(0, b.n);
+  TEST_ASSERT_NULL(b.major);
+}
+
+void test_semverbatch_lens(void) {
+  /* slices of a single buffer, pool grows beyond its initial size */
+  const char line[] = "3.4.5-alpha.beta.gamma.delta.epsilon.zeta.eta.theta+x";
+  const char *strs[64];
+  size_t lens[64];
+  semver_version_batch b;
+  size_t i;
+
+  for (i = 0; i < 64; i++) {
+    strs[i] = line;
+    lens[i] = (i % 2) ? sizeof(line) - 1 : 5;
+  }
+  TEST_ASSERT_EQUAL(SEMVER_OK, semver_version_batch_parse(&b, strs, lens, 64));
+  TEST_ASSERT_EQUAL(64, b.n_ok);
+  for (i = 0; i < 64; i++) {
+    TEST_ASSERT_EQUAL(3, b.major[i]);
+    TEST_ASSERT_EQUAL(5, b.patch[i]);
+    if (i % 2) {
+      TEST_ASSERT_EQUAL_STRING("alpha.beta.gamma.delta.epsilon.zeta.eta.theta",
+                               semver_version_batch_prerelease(&b, i));
+      TEST_ASSERT_EQUAL_STRING("x", semver_version_batch_build(&b, i));
+    } else {
+      TEST_ASSERT_NULL(semver_version_batch_prerelease(&b, i));
+    }
+  }
+  semver_version_batch_destroy(&b);
+
+  TEST_ASSERT_EQUAL(SEMVER_OK, semver_version_batch_parse(&b, strs, lens, 0));
+  TEST_ASSERT_EQUAL(0, b.n);
+  semver_version_batch_destroy(&b);
+
+  /* the size of the columns would wrap around */
+  TEST_ASSERT_EQUAL(SEMVER_ERROR_OUT_OF_MEMORY,
+                    semver_version_batch_parse(&b, strs, lens, (size_t)-1 / 8));
+  TEST_ASSERT_EQUAL(0, b.n);
+  semver_version_batch_destroy(&b);
+}
+
+void run_semverbatch_tests(void) {
+  RUN_TEST(test_semverbatch_parse);
+  RUN_TEST(test_semverbatch_lens);
+}
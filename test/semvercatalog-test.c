@@ -0,0 +1,120 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "semver.h"
+#include "semvercatalog.h"
+#include "semverreq.h"
+
+#include "unity.h"
+
+static const char *catalog_inp[] = {
+    "1.2.0",      "1.0.0",  "2.0.0-rc.1", "1.2.0+b2",   "0.9.0",  "1.10.0",
+    "1.2.0+b1",   "2.0.0",  "1.1.0-beta", "3.0.0-alpha", "1.1.0", "0.1.0",
+};
+
+static const char *catalog_reqs[] = {
+    "^1.0.0",  "~1.2.0",    ">=1.3.0 <1.9.0", ">2.0.0-rc.1", "<1.0.0",
+    "=1.2.0",  ">=0.0.0",   "<0.1.0",         ">3.0.0",      "<=1.1.0-beta",
+    ">=2.0.0-0 <2.0.0",
+};
+
+static const char *catalog_probes[] = {
+    "0.0.1", "0.1.0", "1.2.0", "1.2.0+x", "1.5.0", "2.0.0-rc.0", "2.0.0-rc.1",
+    "3.0.0-alpha", "4.0.0",
+};
+
+/* checks queries against linear scans of the catalog */
+void test_semvercatalog_queries(void) {
+  size_t n = sizeof(catalog_inp) / sizeof(catalog_inp[0]);
+  semver_version vs[sizeof(catalog_inp) / sizeof(catalog_inp[0])];
+  semver_version_req r;
+  semver_version v, lo, hi, fl, ce;
+  semver_catalog c;
+  size_t i, j, begin, end, cnt;
+  char buf[SEMVER_MAXLEN + 1];
+
+  for (i = 0; i < n; i++) {
+    vs[i] = semver_version_from_string(catalog_inp[i]);
+  }
+  c = semver_catalog_new(vs, n);
+  TEST_ASSERT_NOT_NULL(c);
+  for (i = 0; i < n; i++) {
+    semver_version_delete(vs[i]);
+  }
+  TEST_ASSERT_EQUAL(n, semver_catalog_count(c));
+  for (i = 1; i < n; i++) {
+    TEST_ASSERT(semver_version_cmp(semver_catalog_get(c, i - 1),
+                                   semver_catalog_get(c, i)) <= 0);
+  }
+  TEST_ASSERT_NULL(semver_catalog_get(c, n));
+
+  /* equal precedence keeps input order */
+  semver_version_sprint(semver_catalog_get(c, 5), buf);
+  TEST_ASSERT_EQUAL_STRING("1.2.0", buf);
+  semver_version_sprint(semver_catalog_get(c, 7), buf);
+  TEST_ASSERT_EQUAL_STRING("1.2.0+b1", buf);
+
+  for (i = 0; i < sizeof(catalog_reqs) / sizeof(catalog_reqs[0]); i++) {
+    r = semver_version_req_from_string(catalog_reqs[i]);
+    TEST_ASSERT_NOT_NULL(r);
+    lo = hi = 0;
+    cnt = 0;
+    for (j = 0; j < n; j++) {
+      if (semver_version_req_matches(r, semver_catalog_get(c, j))) {
+        lo = lo ? lo : semver_catalog_get(c, j);
+        hi = semver_catalog_get(c, j);
+        cnt++;
+      }
+    }
+    TEST_ASSERT_EQUAL_PTR(lo, semver_catalog_min_satisfying(c, r));
+    TEST_ASSERT_EQUAL_PTR(hi, semver_catalog_max_satisfying(c, r));
+    TEST_ASSERT_EQUAL(cnt, semver_catalog_req_range(c, r, &begin, &end));
+    for (j = begin; j < end; j++) {
+      TEST_ASSERT_TRUE(semver_version_req_matches(r, semver_catalog_get(c, j)));
+    }
+    semver_version_req_delete(r);
+  }
+
+  for (i = 0; i < sizeof(catalog_probes) / sizeof(catalog_probes[0]); i++) {
+    v = semver_version_from_string(catalog_probes[i]);
+    fl = ce = 0;
+    for (j = 0; j < n; j++) {
+      if (semver_version_cmp(semver_catalog_get(c, j), v) <= 0) {
+        fl = semver_catalog_get(c, j);
+      }
+      if (!ce && semver_version_cmp(semver_catalog_get(c, j), v) >= 0) {
+        ce = semver_catalog_get(c, j);
+      }
+    }
+    TEST_ASSERT_EQUAL_PTR(fl, semver_catalog_floor(c, v));
+    TEST_ASSERT_EQUAL_PTR(ce, semver_catalog_ceiling(c, v));
+    semver_version_delete(v);
+  }
+
+  r = semver_version_req_from_string("~1.2.0");
+  semver_version_sprint(semver_catalog_max_satisfying(c, r), buf);
+  TEST_ASSERT_EQUAL_STRING("1.2.0+b1", buf);
+  semver_version_sprint(semver_catalog_min_satisfying(c, r), buf);
+  TEST_ASSERT_EQUAL_STRING("1.2.0", buf);
+  semver_version_req_delete(r);
+
+  semver_catalog_delete(c);
+
+  /* empty catalog */
+  c = semver_catalog_new(NULL, 0);
+  TEST_ASSERT_NOT_NULL(c);
+  r = semver_version_req_from_string(">=0.0.0");
+  TEST_ASSERT_NULL(semver_catalog_max_satisfying(c, r));
+  TEST_ASSERT_NULL(semver_catalog_min_satisfying(c, r));
+  v = semver_version_from_string("1.0.0");
+  TEST_ASSERT_NULL(semver_catalog_floor(c, v));
+  TEST_ASSERT_NULL(semver_catalog_ceiling(c, v));
+  semver_version_delete(v);
+  semver_version_req_delete(r);
+  semver_catalog_delete(c);
+}
+
+void run_semvercatalog_tests(void) {
+  RUN_TEST(test_semvercatalog_queries);
+}
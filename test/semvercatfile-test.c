@@ -0,0 +1,251 @@
+/* mkstemp, write and unlink are POSIX */
+#define _POSIX_C_SOURCE 200809L
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "semver.h"
+#include "semvercatfile.h"
+#include "semverreq.h"
+#include "semversort.h"
+
+#include "unity.h"
+
+#define CATFILE_N 2000
+
+static const char *catfile_pre[] = {
+    NULL,
+    "alpha",
+    "alpha.1",
+    "alpha.beta",
+    "alpha..1",
+    "beta.2",
+    "beta.11",
+    "rc.1",
+    "0.3.7",
+    "x.7.z.92",
+    "identifier.with.a.long.common.prefix.that.exceeds.the.key.1",
+    "identifier.with.a.long.common.prefix.that.exceeds.the.key.2",
+    "identifier.with.a.long.common.prefix.that.exceeds.the.key.2.and.is."
+    "long.enough.to.not.fit.into.the.storage.of.a.version.on.the.stack",
+};
+
+static const char *catfile_build[] = {NULL, "b1", "exp.sha.5114f85", "001"};
+
+static const char *catfile_reqs[] = {
+    "^1.0.0",  "~1.2.0",  ">=1.3.0 <2.1.0", ">2.0.0-rc.1", "<1.0.0",
+    "=1.2.0",  ">=0.0.0", "<0.1.0",         ">3.0.0",      "<=1.1.0-beta",
+    ">=2.0.0-0 <2.0.0",
+};
+
+/* creates a temporary file, *path receives its name */
+int catfile_tmpfile(char *path) {
+  int fd;
+
+  strcpy(path, "/tmp/semver-catfile-test-XXXXXX");
+  fd = mkstemp(path);
+  TEST_ASSERT_TRUE(fd >= 0);
+  return fd;
+}
+
+int catfile_sign(int c) { return (c > 0) - (c < 0); }
+
+/* checks a catalog file against sorted versions vs[0..n) */
+void catfile_check(semver_catfile c, const semver_version *vs, size_t n) {
+  semver_version_storage mem;
+  semver_version_req r;
+  semver_version v;
+  size_t i, begin, end, b2, e2, k;
+  char buf[SEMVER_MAXLEN + 1], exp[SEMVER_MAXLEN + 1];
+
+  TEST_ASSERT_EQUAL(n, semver_catfile_count(c));
+  for (i = 0; i < n; i++) {
+    TEST_ASSERT_EQUAL(semver_version_get_major(vs[i]),
+                      semver_catfile_major(c, i));
+    TEST_ASSERT_EQUAL(semver_version_get_minor(vs[i]),
+                      semver_catfile_minor(c, i));
+    TEST_ASSERT_EQUAL(semver_version_get_patch(vs[i]),
+                      semver_catfile_patch(c, i));
+
+    v = semver_catfile_get(c, i, &mem);
+    TEST_ASSERT_NOT_NULL(v);
+    TEST_ASSERT_EQUAL(0, semver_version_cmp(v, vs[i]));
+    semver_version_sprint(v, buf);
+    semver_version_sprint(vs[i], exp);
+    TEST_ASSERT_EQUAL_STRING(exp, buf);
+    semver_version_copy_prerelease(v, exp, sizeof(exp));
+    if (semver_catfile_prerelease(c, i)) {
+      TEST_ASSERT_EQUAL_STRING(exp, semver_catfile_prerelease(c, i));
+    } else {
+      TEST_ASSERT_EQUAL_STRING("", exp);
+    }
+    semver_version_copy_build(v, exp, sizeof(exp));
+    if (semver_catfile_build(c, i)) {
+      TEST_ASSERT_EQUAL_STRING(exp, semver_catfile_build(c, i));
+    } else {
+      TEST_ASSERT_EQUAL_STRING("", exp);
+    }
+
+    TEST_ASSERT_EQUAL(semver_version_lower_bound(vs, n, v),
+                      semver_catfile_lower_bound(c, v));
+    semver_version_destroy(v);
+
+    if (i > 0) {
+      k = i - 1 - (size_t)rand() % i;
+      TEST_ASSERT_EQUAL(catfile_sign(semver_version_cmp(vs[k], vs[i])),
+                        semver_catfile_cmp(c, k, i));
+      TEST_ASSERT_EQUAL(catfile_sign(semver_version_cmp(vs[i], vs[k])),
+                        semver_catfile_cmp(c, i, k));
+    }
+  }
+
+  for (i = 0; i < sizeof(catfile_reqs) / sizeof(catfile_reqs[0]); i++) {
+    r = semver_version_req_from_string(catfile_reqs[i]);
+    TEST_ASSERT_NOT_NULL(r);
+    k = semver_version_req_range(r, vs, n, &b2, &e2);
+    TEST_ASSERT_EQUAL(k, semver_catfile_req_range(c, r, &begin, &end));
+    TEST_ASSERT_EQUAL(b2, begin);
+    TEST_ASSERT_EQUAL(e2, end);
+    semver_version_req_delete(r);
+  }
+}
+
+/* writes random versions to a file, maps it and checks it */
+void test_semvercatfile_roundtrip(void) {
+  semver_version *vs = malloc(CATFILE_N * sizeof(semver_version));
+  semver_version *sorted = malloc(CATFILE_N * sizeof(semver_version));
+  semver_catfile c;
+  const char *pre, *build;
+  size_t i;
+  char path[64], buf[SEMVER_MAXLEN + 1];
+  int fd;
+
+  srand(25);
+  for (i = 0; i < CATFILE_N; i++) {
+    pre = catfile_pre[rand() % (sizeof(catfile_pre) / sizeof(catfile_pre[0]))];
+    build = catfile_build[rand() %
+                          (sizeof(catfile_build) / sizeof(catfile_build[0]))];
+    sprintf(buf, "%d.%d.%d%s%s%s%s", rand() % 4, rand() % 4, rand() % 3,
+            pre ? "-" : "", pre ? pre : "", build ? "+" : "",
+            build ? build : "");
+    vs[i] = semver_version_from_string(buf);
+    TEST_ASSERT_NOT_NULL(vs[i]);
+    sorted[i] = vs[i];
+  }
+  TEST_ASSERT_EQUAL(SEMVER_OK, semver_version_sort(sorted, CATFILE_N));
+
+  fd = catfile_tmpfile(path);
+  TEST_ASSERT_EQUAL(SEMVER_OK, semver_catfile_write(fd, vs, CATFILE_N));
+  close(fd);
+  TEST_ASSERT_EQUAL(SEMVER_OK, semver_catfile_open(path, &c));
+  unlink(path);
+  catfile_check(c, sorted, CATFILE_N);
+  semver_catfile_close(c);
+
+  /* empty catalog */
+  fd = catfile_tmpfile(path);
+  TEST_ASSERT_EQUAL(SEMVER_OK, semver_catfile_write(fd, NULL, 0));
+  close(fd);
+  TEST_ASSERT_EQUAL(SEMVER_OK, semver_catfile_open(path, &c));
+  unlink(path);
+  catfile_check(c, NULL, 0);
+  semver_catfile_close(c);
+
+  for (i = 0; i < CATFILE_N; i++) {
+    semver_version_delete(vs[i]);
+  }
+  free(vs);
+  free(sorted);
+}
+
+/* replaces the contents of the file at path with buf[0..len) */
+void catfile_put(const char *path, const char *buf, size_t len) {
+  int fd = open(path, O_WRONLY | O_TRUNC);
+  TEST_ASSERT_TRUE(fd >= 0);
+  TEST_ASSERT_TRUE(write(fd, buf, len) == (ssize_t)len);
+  close(fd);
+}
+
+/* writes a catalog of versions vs[0..n) to path, and reads it into buf */
+size_t catfile_get(const char *path, const semver_version *vs, size_t n,
+                   char *buf, size_t size) {
+  ssize_t len;
+  int fd = open(path, O_RDWR | O_TRUNC);
+
+  TEST_ASSERT_TRUE(fd >= 0);
+  TEST_ASSERT_EQUAL(SEMVER_OK, semver_catfile_write(fd, vs, n));
+  lseek(fd, 0, SEEK_SET);
+  len = read(fd, buf, size);
+  TEST_ASSERT_TRUE(len > 0);
+  close(fd);
+  return (size_t)len;
+}
+
+/* rejects files that are not valid catalog files */
+void test_semvercatfile_invalid(void) {
+  static const char bad[] = {'.', '!', '\0', '+'};
+  semver_version vs[2];
+  semver_catfile c = 0;
+  char path[64], buf[4096], pre[53];
+  size_t len, i, off;
+
+  TEST_ASSERT_EQUAL(SEMVER_ERROR_IO,
+                    semver_catfile_open("/nonexistent/semver.cat", &c));
+
+  vs[0] = semver_version_from_string("1.0.0-alpha+b1");
+  vs[1] = semver_version_from_string("0.1.0");
+  close(catfile_tmpfile(path));
+  len = catfile_get(path, vs, 2, buf, sizeof(buf));
+
+  /* truncated */
+  catfile_put(path, buf, len - 1);
+  TEST_ASSERT_EQUAL(SEMVER_ERROR_STRUCTURE, semver_catfile_open(path, &c));
+
+  /* bad magic */
+  buf[0] = 'x';
+  catfile_put(path, buf, len);
+  TEST_ASSERT_EQUAL(SEMVER_ERROR_STRUCTURE, semver_catfile_open(path, &c));
+
+  /* too short for a header */
+  catfile_put(path, "semvcat\n", 8);
+  TEST_ASSERT_EQUAL(SEMVER_ERROR_STRUCTURE, semver_catfile_open(path, &c));
+  semver_version_delete(vs[0]);
+  semver_version_delete(vs[1]);
+
+  /* corrupted records: strings that do not match their identifier count,
+   * or with characters a version cannot hold */
+  memset(pre, 'a', 52);
+  pre[52] = '\0';
+  sprintf(buf, "1.0.0-%s", pre);
+  vs[0] = semver_version_from_string(buf);
+  TEST_ASSERT_NOT_NULL(vs[0]);
+  len = catfile_get(path, vs, 1, buf, sizeof(buf));
+  for (off = 0; off + 52 <= len && memcmp(buf + off, pre, 52) != 0; off++) {
+  }
+  TEST_ASSERT_TRUE(off + 52 <= len);
+  catfile_put(path, buf, len);
+  TEST_ASSERT_EQUAL(SEMVER_OK, semver_catfile_open(path, &c));
+  semver_catfile_close(c);
+  c = 0;
+
+  memset(buf + off, '.', 52);
+  catfile_put(path, buf, len);
+  TEST_ASSERT_EQUAL(SEMVER_ERROR_STRUCTURE, semver_catfile_open(path, &c));
+  for (i = 0; i < sizeof(bad); i++) {
+    memset(buf + off, 'a', 52);
+    buf[off + 7] = bad[i];
+    catfile_put(path, buf, len);
+    TEST_ASSERT_EQUAL(SEMVER_ERROR_STRUCTURE, semver_catfile_open(path, &c));
+  }
+
+  TEST_ASSERT_NULL(c);
+  unlink(path);
+  semver_version_delete(vs[0]);
+}
+
+void run_semvercatfile_tests(void) {
+  RUN_TEST(test_semvercatfile_roundtrip);
+  RUN_TEST(test_semvercatfile_invalid);
+}
@@ -0,0 +1,166 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "semver.h"
+
+#include "unity.h"
+
+/* ordered by precedence, neighbours with equal precedence marked below */
+static const char *collate_inp[] = {
+    "0.0.0",
+    "0.0.1-0",
+    "0.0.1-1",
+    "0.0.1-9",
+    "0.0.1-10",
+    "0.0.1-99999999999999999999",
+    "0.0.1-100000000000000000000",
+    "0.0.1--",
+    "0.0.1-A",
+    "0.0.1-a",
+    "0.0.1-a.1",
+    "0.0.1-a.a",
+    "0.0.1-ab",
+    "0.0.1-b",
+    "0.0.1",
+    "0.1.0",
+    "1.0.0-alpha",
+    "1.0.0-alpha.1",
+    "1.0.0-alpha.beta",
+    "1.0.0-beta",
+    "1.0.0-beta.2",
+    "1.0.0-beta.11",
+    "1.0.0-rc.1",
+    "1.0.0",
+    "1.0.0+build.1",
+    "1.0.255",
+    "1.0.256",
+    "1.255.0",
+    "255.0.0",
+    "256.0.0",
+    "65536.0.0",
+    "4294967295.0.0",
+};
+
+int collate_sign(int x) { return (x > 0) - (x < 0); }
+
+int collate_cmp(const unsigned char *a, size_t na, const unsigned char *b,
+                size_t nb) {
+  int k = memcmp(a, b, na < nb ? na : nb);
+  if (k != 0) {
+    return collate_sign(k);
+  }
+  return (na > nb) - (na < nb);
+}
+
+void test_semvercollate_order(void) {
+  const size_t n = sizeof(collate_inp) / sizeof(const char *);
+  unsigned char ka[SEMVER_COLLATION_KEY_MAXLEN];
+  unsigned char kb[SEMVER_COLLATION_KEY_MAXLEN];
+  semver_version a, b;
+  size_t i, j, na, nb;
+
+  for (i = 0; i < n; i++) {
+    a = semver_version_from_string(collate_inp[i]);
+    TEST_ASSERT_NOT_NULL(a);
+    na = semver_version_collation_key(a, 0, ka, sizeof(ka));
+    for (j = 0; j < n; j++) {
+      b = semver_version_from_string(collate_inp[j]);
+      nb = semver_version_collation_key(b, 0, kb, sizeof(kb));
+      TEST_ASSERT_EQUAL(collate_sign(semver_version_cmp(a, b)),
+                        collate_cmp(ka, na, kb, nb));
+      semver_version_delete(b);
+    }
+    semver_version_delete(a);
+  }
+}
+
+/* malformed keys of 1.0.0 with a prerelease */
+static const struct {
+  unsigned char key[16];
+  size_t len;
+} collate_bad[] = {
+    /* '.' within alphanumeric identifiers */
+    {{1, 1, 0, 0, 3, 'a', '.', 'b', '.', 'c', '.', 'd', '.', 'e', 0, 1}, 16},
+    {{1, 1, 0, 0, 3, '.', 0, 1}, 8},
+    /* '.' within a numeric identifier */
+    {{1, 1, 0, 0, 2, 3, '1', '.', '2', 1}, 10},
+    /* numeric identifier with other characters */
+    {{1, 1, 0, 0, 2, 2, '1', 'a', 1}, 9},
+    /* alphanumeric identifier of digits only */
+    {{1, 1, 0, 0, 3, '1', '2', 0, 1}, 9},
+};
+
+void test_semvercollate_roundtrip(void) {
+  const char *with_build[] = {"1.2.3+build.5", "1.0.0-rc.1+sha.0a1b",
+                              "1.0.0+", "1.0.0-x.7.z.92"};
+  const size_t n = sizeof(collate_inp) / sizeof(const char *);
+  unsigned char k[SEMVER_COLLATION_KEY_MAXLEN];
+  unsigned char k2[SEMVER_COLLATION_KEY_MAXLEN];
+  char buf[SEMVER_MAXLEN];
+  semver_version v, d;
+  size_t i, len;
+
+  for (i = 0; i < n; i++) {
+    v = semver_version_from_string(collate_inp[i]);
+    len = semver_version_collation_key(v, 0, k, sizeof(k));
+    d = semver_version_from_collation_key(k, len);
+    TEST_ASSERT_NOT_NULL(d);
+    semver_version_sprint(d, buf);
+    TEST_ASSERT_EQUAL_STRING(i == 24 ? "1.0.0" : collate_inp[i], buf);
+    semver_version_delete(d);
+    semver_version_delete(v);
+  }
+
+  for (i = 0; i < sizeof(with_build) / sizeof(const char *); i++) {
+    v = semver_version_from_string(with_build[i]);
+    len = semver_version_collation_key(v, SEMVER_COLLATE_WITH_BUILD, k,
+                                       sizeof(k));
+    d = semver_version_from_collation_key(k, len);
+    TEST_ASSERT_NOT_NULL(d);
+    semver_version_sprint(d, buf);
+    TEST_ASSERT_EQUAL_STRING(with_build[i], buf);
+    semver_version_delete(d);
+
+    /* truncated buffers report the full length */
+    TEST_ASSERT_EQUAL(len, semver_version_collation_key(
+                               v, SEMVER_COLLATE_WITH_BUILD, k2, 3));
+    TEST_ASSERT_EQUAL_MEMORY(k, k2, 3);
+    TEST_ASSERT_EQUAL(len, semver_version_collation_key(
+                               v, SEMVER_COLLATE_WITH_BUILD, NULL, 0));
+    semver_version_delete(v);
+  }
+
+  /* malformed keys */
+  TEST_ASSERT_NULL(semver_version_from_collation_key(k, 0));
+  TEST_ASSERT_NULL(semver_version_from_collation_key(NULL, 3));
+  v = semver_version_from_string("1.0.0-rc.1");
+  len = semver_version_collation_key(v, 0, k, sizeof(k));
+  for (i = 0; i < len; i++) {
+    TEST_ASSERT_NULL(semver_version_from_collation_key(k, i));
+  }
+  k[len - 1] = 0x7f;
+  TEST_ASSERT_NULL(semver_version_from_collation_key(k, len));
+  semver_version_delete(v);
+
+  /* each tag must hold one identifier of its kind */
+  for (i = 0; i < sizeof(collate_bad) / sizeof(collate_bad[0]); i++) {
+    TEST_ASSERT_NULL(semver_version_from_collation_key(
+        collate_bad[i].key, collate_bad[i].len));
+  }
+
+  /* empty identifiers are alphanumeric */
+  v = semver_version_from_string("1.0.0-a..1");
+  len = semver_version_collation_key(v, 0, k, sizeof(k));
+  d = semver_version_from_collation_key(k, len);
+  TEST_ASSERT_NOT_NULL(d);
+  TEST_ASSERT_EQUAL(0, semver_version_cmp(v, d));
+  semver_version_sprint(d, buf);
+  TEST_ASSERT_EQUAL_STRING("1.0.0-a..1", buf);
+  semver_version_delete(d);
+  semver_version_delete(v);
+}
+
+void run_semvercollate_tests(void) {
+  RUN_TEST(test_semvercollate_order);
+  RUN_TEST(test_semvercollate_roundtrip);
+}
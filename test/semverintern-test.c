@@ -0,0 +1,144 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "semver.h"
+#include "semverintern.h"
+
+#include "unity.h"
+
+void test_semverintern_ids(void) {
+  semver_intern t = semver_intern_new();
+  unsigned long a, b, c, d, id;
+
+  TEST_ASSERT_NOT_NULL(t);
+  TEST_ASSERT_EQUAL(0, semver_intern_count(t));
+  TEST_ASSERT_EQUAL(SEMVER_OK, semver_intern_string(t, "1.2.3", &a));
+  TEST_ASSERT_EQUAL(SEMVER_OK, semver_intern_string(t, "1.2.3-rc.1", &b));
+  TEST_ASSERT_EQUAL(SEMVER_OK, semver_intern_strn(t, "1.2.3+abc", 9, &c));
+  TEST_ASSERT_EQUAL(0, a);
+  TEST_ASSERT_EQUAL(1, b);
+  TEST_ASSERT_EQUAL(2, c);
+
+  /* same version, same ID */
+  TEST_ASSERT_EQUAL(SEMVER_OK, semver_intern_strn(t, "1.2.3-rc.1xyz", 10, &d));
+  TEST_ASSERT_EQUAL(b, d);
+  TEST_ASSERT_EQUAL(SEMVER_OK, semver_intern_string(t, "1.2.3+abc", &d));
+  TEST_ASSERT_EQUAL(c, d);
+  /* build metadata is part of the identity */
+  TEST_ASSERT_EQUAL(SEMVER_OK, semver_intern_string(t, "1.2.3+abd", &d));
+  TEST_ASSERT_EQUAL(3, d);
+  TEST_ASSERT_EQUAL(4, semver_intern_count(t));
+
+  TEST_ASSERT_EQUAL(1, semver_intern_find(t, "1.2.3-rc.1", 10, &id));
+  TEST_ASSERT_EQUAL(b, id);
+  TEST_ASSERT_EQUAL(0, semver_intern_find(t, "1.2.4", 5, &id));
+  TEST_ASSERT_EQUAL(4, semver_intern_count(t));
+
+  TEST_ASSERT_EQUAL_STRING("1.2.3+abc", semver_intern_str(t, c));
+  TEST_ASSERT_EQUAL(3, semver_version_get_patch(semver_intern_get(t, a)));
+  TEST_ASSERT_EQUAL(0, semver_version_cmp(semver_intern_get(t, a),
+                                          semver_intern_get(t, c)));
+  TEST_ASSERT_NULL(semver_intern_get(t, 4));
+  TEST_ASSERT_NULL(semver_intern_str(t, 4));
+
+  /* invalid versions are not interned */
+  TEST_ASSERT_EQUAL(SEMVER_ERROR_PARSE_NOT_ALLOWED_HERE,
+                    semver_intern_string(t, "1.2.x", &id));
+  TEST_ASSERT_NOT_EQUAL(SEMVER_OK, semver_intern_string(t, "", &id));
+  TEST_ASSERT_NOT_EQUAL(SEMVER_OK, semver_intern_string(t, NULL, &id));
+  TEST_ASSERT_EQUAL(4, semver_intern_count(t));
+
+  semver_intern_delete(t);
+  semver_intern_delete(NULL);
+}
+
+void test_semverintern_many(void) {
+  semver_intern t = semver_intern_new();
+  semver_version v;
+  char buf[64];
+  unsigned long i, id;
+
+  /* grows the table several times */
+  for (i = 0; i < 5000; i++) {
+    sprintf(buf, "%lu.%lu.%lu-beta.%lu", i % 7, i % 13, i, i % 3);
+    TEST_ASSERT_EQUAL(SEMVER_OK, semver_intern_string(t, buf, &id));
+    TEST_ASSERT_EQUAL(i, id);
+  }
+  for (i = 0; i < 5000; i++) {
+    sprintf(buf, "%lu.%lu.%lu-beta.%lu", i % 7, i % 13, i, i % 3);
+    TEST_ASSERT_EQUAL(1, semver_intern_find(t, buf, strlen(buf), &id));
+    TEST_ASSERT_EQUAL(i, id);
+    TEST_ASSERT_EQUAL_STRING(buf, semver_intern_str(t, i));
+    TEST_ASSERT_EQUAL(i, semver_version_get_patch(semver_intern_get(t, i)));
+  }
+  TEST_ASSERT_EQUAL(5000, semver_intern_count(t));
+
+  /* interning a parsed version */
+  v = semver_version_from_string("2.0.0-alpha+001");
+  TEST_ASSERT_EQUAL(SEMVER_OK, semver_intern_version(t, v, &id));
+  TEST_ASSERT_EQUAL(5000, id);
+  TEST_ASSERT_EQUAL(SEMVER_OK, semver_intern_string(t, "2.0.0-alpha+001", &id));
+  TEST_ASSERT_EQUAL(5000, id);
+  TEST_ASSERT_EQUAL(SEMVER_OK,
+                    semver_intern_version(t, semver_intern_get(t, 17), &id));
+  TEST_ASSERT_EQUAL(17, id);
+  semver_version_delete(v);
+
+  semver_intern_delete(t);
+}
+
+/* fails plain allocations, e.g. of the slots, but not reallocations */
+void *intern_failing_malloc(void *user, size_t size) {
+  return 0;
+}
+
+void *intern_realloc(void *user, void *ptr, size_t size) {
+  return realloc(ptr, size);
+}
+
+void intern_free(void *user, void *ptr) {
+  free(ptr);
+}
+
+void test_semverintern_out_of_memory(void) {
+  semver_intern t = semver_intern_new();
+  semver_allocator a, prev;
+  char buf[64];
+  unsigned long i, id;
+  size_t n;
+  int k = SEMVER_OK;
+
+  a.malloc_fn = intern_failing_malloc;
+  a.realloc_fn = intern_realloc;
+  a.free_fn = intern_free;
+  a.user = 0;
+  semver_get_allocator(&prev);
+  semver_set_allocator(&a);
+
+  /* the table cannot grow: inserts fail before it fills up */
+  for (i = 0; i < 200 && k == SEMVER_OK; i++) {
+    sprintf(buf, "1.0.%lu", i);
+    k = semver_intern_string(t, buf, &id);
+  }
+  TEST_ASSERT_EQUAL(SEMVER_ERROR_OUT_OF_MEMORY, k);
+  n = semver_intern_count(t);
+  TEST_ASSERT_TRUE(n > 0 && n < 200);
+  TEST_ASSERT_EQUAL(0, semver_intern_find(t, "2.0.0", 5, &id));
+  TEST_ASSERT_EQUAL(SEMVER_OK, semver_intern_string(t, "1.0.0", &id));
+  TEST_ASSERT_EQUAL(0, id);
+
+  semver_set_allocator(&prev);
+  for (i = 0; i < 200; i++) {
+    sprintf(buf, "1.0.%lu", i);
+    TEST_ASSERT_EQUAL(SEMVER_OK, semver_intern_string(t, buf, &id));
+    TEST_ASSERT_EQUAL(i, id);
+  }
+  semver_intern_delete(t);
+}
+
+void run_semverintern_tests(void) {
+  RUN_TEST(test_semverintern_ids);
+  RUN_TEST(test_semverintern_many);
+  RUN_TEST(test_semverintern_out_of_memory);
+}
@@ -0,0 +1,83 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "semver.h"
+#include "semvermatrix.h"
+#include "semverreq.h"
+
+#include "unity.h"
+
+static const char *matrix_reqs[] = {
+    ">=1.0.0 <2.0.0", ">1.0.0",        "<=1.2.3",     "=1.2.3",
+    "^1.2.3",         "~0.2.0",        "<1.0.0",      ">1.0.0-rc.1",
+    "=1.0.0-rc.1",    ">=0.0.0",       ">3.0.0-beta <=3.1.0", ">=2.1.0 <2.1.0",
+};
+
+/* checks the matrix against semver_version_req_matches for n versions */
+void matrix_check(semver_version_req *reqs, size_t m, semver_version *vs,
+                  size_t n) {
+  size_t row = SEMVERREQ_BITMAP_SIZE(n);
+  unsigned char *bitmap = malloc(SEMVER_MATRIX_SIZE(m, n) + 1);
+  size_t *counts = malloc(m * sizeof(size_t));
+  size_t r, i, expect;
+
+  bitmap[SEMVER_MATRIX_SIZE(m, n)] = 0xa5;
+  TEST_ASSERT_EQUAL(SEMVER_OK, semver_version_req_match_matrix(
+                                   reqs, m, vs, n, bitmap, counts));
+  for (r = 0; r < m; r++) {
+    expect = 0;
+    for (i = 0; i < n; i++) {
+      TEST_ASSERT_EQUAL(semver_version_req_matches(reqs[r], vs[i]),
+                        (bitmap[r * row + i / 8] >> (i % 8)) & 1);
+      expect += semver_version_req_matches(reqs[r], vs[i]);
+    }
+    for (; i < row * 8; i++) {
+      TEST_ASSERT_EQUAL(0, (bitmap[r * row + i / 8] >> (i % 8)) & 1);
+    }
+    TEST_ASSERT_EQUAL(expect, counts[r]);
+  }
+  TEST_ASSERT_EQUAL(0xa5, bitmap[SEMVER_MATRIX_SIZE(m, n)]);
+
+  free(counts);
+  free(bitmap);
+}
+
+void test_semvermatrix_match(void) {
+  size_t m = sizeof(matrix_reqs) / sizeof(matrix_reqs[0]);
+  semver_version_req reqs[sizeof(matrix_reqs) / sizeof(matrix_reqs[0])];
+  semver_version vs[1300];
+  char buf[64];
+  size_t i;
+
+  for (i = 0; i < m; i++) {
+    reqs[i] = semver_version_req_from_string(matrix_reqs[i]);
+    TEST_ASSERT_NOT_NULL(reqs[i]);
+  }
+  for (i = 0; i < 1300; i++) {
+    sprintf(buf, "%lu.%lu.%lu%s", (unsigned long)(i % 4),
+            (unsigned long)(i % 3), (unsigned long)(i % 5),
+            i % 7 == 0 ? "-rc.1" : (i % 11 == 0 ? "-beta" : ""));
+    vs[i] = semver_version_from_string(buf);
+  }
+
+  /* several tiles, partial bytes, and the empty cases */
+  matrix_check(reqs, m, vs, 1300);
+  matrix_check(reqs, m, vs, 1027);
+  matrix_check(reqs, m, vs, 13);
+  matrix_check(reqs, 1, vs, 8);
+  matrix_check(reqs, m, vs, 0);
+  TEST_ASSERT_EQUAL(SEMVER_OK,
+                    semver_version_req_match_matrix(reqs, 0, vs, 1300, 0, 0));
+
+  for (i = 0; i < m; i++) {
+    semver_version_req_delete(reqs[i]);
+  }
+  for (i = 0; i < 1300; i++) {
+    semver_version_delete(vs[i]);
+  }
+}
+
+void run_semvermatrix_tests(void) {
+  RUN_TEST(test_semvermatrix_match);
+}
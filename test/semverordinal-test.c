@@ -0,0 +1,117 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "semver.h"
+#include "semverordinal.h"
+#include "semverreq.h"
+
+#include "unity.h"
+
+static const char *ordinal_inp[] = {
+    "1.0.0",        "0.9.1",     "2.0.0-rc.1", "1.0.0+build.5", "1.10.0",
+    "1.2.0",        "2.0.0",     "1.2.0-beta", "1.2.0-alpha.2", "1.2.0-alpha.10",
+    "0.0.1",        "3.1.4",     "2.0.0-rc.1", "1.2.3",         "1.2.10",
+};
+/* distinct precedences of the above */
+#define ORDINAL_N_RANKS 13
+
+static const char *ordinal_reqs[] = {
+    ">=1.0.0 <2.0.0", ">1.0.0",  "<=1.2.0", "=2.0.0-rc.1", "^1.2.0",
+    "~1.2.0",         ">=5.0.0", "<0.0.1",  ">0.9.1 <1.0.0", ">=0.0.0",
+};
+
+void test_semverordinal_ranks(void) {
+  semver_version vs[15];
+  semver_version v;
+  semver_ordinal m;
+  char buf[SEMVER_MAXLEN + 1];
+  size_t i, j, r, rj, n = sizeof(ordinal_inp) / sizeof(ordinal_inp[0]);
+  int c;
+
+  for (i = 0; i < n; i++) {
+    vs[i] = semver_version_from_string(ordinal_inp[i]);
+  }
+  m = semver_ordinal_new(vs, n);
+  TEST_ASSERT_NOT_NULL(m);
+  TEST_ASSERT_EQUAL(ORDINAL_N_RANKS, semver_ordinal_count(m));
+
+  /* ranks compare like versions */
+  for (i = 0; i < n; i++) {
+    TEST_ASSERT_EQUAL(1, semver_ordinal_rank(m, vs[i], &r));
+    TEST_ASSERT_EQUAL(0, semver_version_cmp(vs[i], semver_ordinal_get(m, r)));
+    TEST_ASSERT_EQUAL(r, semver_ordinal_lower_bound(m, vs[i]));
+    for (j = 0; j < n; j++) {
+      semver_ordinal_rank(m, vs[j], &rj);
+      c = semver_version_cmp(vs[i], vs[j]);
+      TEST_ASSERT_EQUAL(c < 0, r < rj);
+      TEST_ASSERT_EQUAL(c == 0, r == rj);
+    }
+  }
+  semver_version_sprint(semver_ordinal_get(m, 0), buf);
+  TEST_ASSERT_EQUAL_STRING("0.0.1", buf);
+  semver_version_sprint(semver_ordinal_get(m, 4), buf);
+  TEST_ASSERT_EQUAL_STRING("1.2.0-alpha.10", buf);
+  TEST_ASSERT_NULL(semver_ordinal_get(m, ORDINAL_N_RANKS));
+
+  /* the map owns copies of the versions */
+  for (i = 0; i < n; i++) {
+    semver_version_delete(vs[i]);
+  }
+
+  v = semver_version_from_string("1.2.1");
+  TEST_ASSERT_EQUAL(0, semver_ordinal_rank(m, v, &r));
+  /* between 1.2.0 and 1.2.3 */
+  TEST_ASSERT_EQUAL(7, semver_ordinal_lower_bound(m, v));
+  semver_version_delete(v);
+  v = semver_version_from_string("9.0.0");
+  TEST_ASSERT_EQUAL(ORDINAL_N_RANKS, semver_ordinal_lower_bound(m, v));
+  semver_version_delete(v);
+
+  semver_ordinal_delete(m);
+}
+
+void test_semverordinal_req_range(void) {
+  semver_version vs[15];
+  semver_version_req req;
+  semver_ordinal m;
+  size_t i, k, r, begin, end, cnt;
+  size_t n = sizeof(ordinal_inp) / sizeof(ordinal_inp[0]);
+
+  for (i = 0; i < n; i++) {
+    vs[i] = semver_version_from_string(ordinal_inp[i]);
+  }
+  m = semver_ordinal_new(vs, n);
+
+  for (k = 0; k < sizeof(ordinal_reqs) / sizeof(ordinal_reqs[0]); k++) {
+    req = semver_version_req_from_string(ordinal_reqs[k]);
+    TEST_ASSERT_NOT_NULL(req);
+    cnt = semver_ordinal_req_range(m, req, &begin, &end);
+    TEST_ASSERT_EQUAL(end - begin, cnt);
+    TEST_ASSERT(begin <= end && end <= ORDINAL_N_RANKS);
+    for (i = 0; i < n; i++) {
+      semver_ordinal_rank(m, vs[i], &r);
+      TEST_ASSERT_EQUAL(semver_version_req_matches(req, vs[i]),
+                        begin <= r && r < end);
+    }
+    semver_version_req_delete(req);
+  }
+
+  for (i = 0; i < n; i++) {
+    semver_version_delete(vs[i]);
+  }
+  semver_ordinal_delete(m);
+
+  /* empty set */
+  m = semver_ordinal_new(NULL, 0);
+  TEST_ASSERT_NOT_NULL(m);
+  TEST_ASSERT_EQUAL(0, semver_ordinal_count(m));
+  req = semver_version_req_from_string(">=1.0.0");
+  TEST_ASSERT_EQUAL(0, semver_ordinal_req_range(m, req, &begin, &end));
+  semver_version_req_delete(req);
+  semver_ordinal_delete(m);
+}
+
+void run_semverordinal_tests(void) {
+  RUN_TEST(test_semverordinal_ranks);
+  RUN_TEST(test_semverordinal_req_range);
+}
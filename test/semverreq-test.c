@@ -1,3 +1,4 @@
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -367,6 +368,245 @@ void test_semverreq_match_invalid(void) {
   }
 }
 
+void test_semverreq_strn(void) {
+  const char buf[] = ">=1.0.0 <2.0.0;^3.4.5";
+  const char nul[] = ">=1.0.0\0<2.0.0";
+  semver_version_req_storage mem;
+  semver_version_req_wrapped w;
+  semver_version_req r;
+  char out[256];
+
+  r = semver_version_req_from_strn(buf, 14);
+  TEST_ASSERT_NOT_NULL(r);
+  semver_version_req_sprint(r, out);
+  TEST_ASSERT_EQUAL_STRING(">=1.0.0 <2.0.0", out);
+  semver_version_req_delete(r);
+
+  /* only the first part */
+  r = semver_version_req_init_from_strn(&mem, buf, 7);
+  TEST_ASSERT_NOT_NULL(r);
+  semver_version_req_sprint(r, out);
+  TEST_ASSERT_EQUAL_STRING(">=1.0.0", out);
+  semver_version_req_destroy(r);
+
+  r = semver_version_req_init_from_strn(&mem, buf + 15, 6);
+  TEST_ASSERT_NOT_NULL(r);
+  semver_version_req_sprint(r, out);
+  TEST_ASSERT_EQUAL_STRING(">=3.4.5 <4.0.0", out);
+  semver_version_req_destroy(r);
+
+  w = semver_version_req_from_strn_wrapped(buf, 0);
+  TEST_ASSERT_EQUAL(1, w.err);
+  TEST_ASSERT_EQUAL(SEMVERREQ_EOI, w.unwrap.code);
+
+  /* embedded NUL within len is rejected */
+  w = semver_version_req_from_strn_wrapped(nul, sizeof(nul) - 1);
+  TEST_ASSERT_EQUAL(1, w.err);
+}
+
+void test_semverreq_storage(void) {
+  const exp5_t tests[] = {
+      { "1.4.2",       ">=1.4.0 <2.0.0", 1 },
+      { "2.0.0",       ">=1.4.0 <2.0.0", 0 },
+      { "1.9.9",       "<=2.0.0", 1 },
+      { "2.0.1",       "<=2.0.0", 0 },
+      { "1.1.3",       "~1.1.0", 1 },
+      { "1.0.0-alpha.1+build.5", "=1.0.0-alpha.1+build.5", 1 },
+  };
+  const size_t n = sizeof(tests)/sizeof(exp5_t);
+  semver_version_req_storage arr[2];
+  semver_version_storage v_mem;
+  semver_version_req r;
+  semver_version_req_wrapped w;
+  semver_version v;
+  char buf[SEMVERREQ_MAXLEN];
+  size_t i;
+
+  for (i = 0; i < n; i++) {
+    r = semver_version_req_init_from_string(&arr[0], tests[i].r);
+    TEST_ASSERT_NOT_NULL(r);
+    TEST_ASSERT_EQUAL_PTR(&arr[0], r);
+    v = semver_version_init_from_string(&v_mem, tests[i].v);
+    TEST_ASSERT_NOT_NULL(v);
+
+    TEST_ASSERT_EQUAL(tests[i].res, semver_version_req_matches(r, v));
+
+    /* storage may be moved */
+    memcpy(&arr[1], &arr[0], sizeof(arr[0]));
+    r = (semver_version_req)&arr[1];
+    TEST_ASSERT_EQUAL(tests[i].res, semver_version_req_matches(r, v));
+
+    semver_version_destroy(v);
+    semver_version_req_destroy(r);
+  }
+
+  r = semver_version_req_init_from_string(&arr[0], " >= 0.0.1; < 1.0.0  ");
+  semver_version_req_sprint(r, buf);
+  TEST_ASSERT_EQUAL_STRING(">=0.0.1 <1.0.0", buf);
+  semver_version_req_delete(r);
+
+  w = semver_version_req_init_from_string_wrapped(&arr[0], ">=1.0.0 !2.0.0");
+  TEST_ASSERT_TRUE(w.err);
+  w = semver_version_req_init_from_string_wrapped(&arr[0], "");
+  TEST_ASSERT_TRUE(w.err);
+  TEST_ASSERT_EQUAL(SEMVERREQ_EOI, w.unwrap.code);
+}
+
+void *failing_malloc(void *user, size_t size) {
+  return 0;
+}
+
+void *failing_realloc(void *user, void *ptr, size_t size) {
+  return 0;
+}
+
+void failing_free(void *user, void *ptr) {
+  free(ptr);
+}
+
+void test_semverreq_out_of_memory(void) {
+  semver_allocator a, prev;
+  semver_version_req_storage mem;
+  semver_version_req_wrapped w;
+  semver_version_req r;
+  int res = 99;
+
+  a.malloc_fn = failing_malloc;
+  a.realloc_fn = failing_realloc;
+  a.free_fn = failing_free;
+  a.user = 0;
+  semver_get_allocator(&prev);
+  semver_set_allocator(&a);
+
+  w = semver_version_req_from_string_wrapped(">=1.0.0 <2.0.0");
+  TEST_ASSERT_TRUE(w.err);
+  TEST_ASSERT_EQUAL(SEMVERREQ_OUT_OF_MEMORY, w.unwrap.code);
+
+  /* caller-provided storage does not need the allocator */
+  r = semver_version_req_init_from_string(&mem, ">=1.0.0 <2.0.0");
+  TEST_ASSERT_NOT_NULL(r);
+  semver_version_req_destroy(r);
+  TEST_ASSERT_EQUAL(0, semver_matches("1.5.0", "^1.0.0", &res));
+  TEST_ASSERT_EQUAL(1, res);
+
+  semver_set_allocator(&prev);
+}
+
+static const char *compiled_reqs[] = {
+    ">=1.0.0 <2.0.0", ">1.0.0", "<=1.2.3",      "=1.2.3",        "^1.2.3",
+    "~0.2.0",         "<1.0.0", ">1.0.0-rc.1",  ">=2.0.0-alpha <2.0.0",
+    "=1.0.0-beta.2",  ">=0.0.0", ">=1.2.4294967290 <=1.2.4294967295",
+    ">1.4294967295.0",
+};
+
+static const char *compiled_versions[] = {
+    "0.0.0",        "0.2.0",       "0.2.9",       "0.3.0-0",       "1.0.0-rc.1",
+    "1.0.0-rc.2",   "1.0.0",       "1.0.0+b",     "1.0.1",         "1.2.3-pre",
+    "1.2.3",        "1.2.3+b",     "1.9.9",       "2.0.0-0",       "2.0.0-alpha",
+    "2.0.0-beta",   "2.0.0",       "1.0.0-beta.2", "1.0.0-beta.10", "3.0.0",
+    "1.2.4294967290", "1.2.4294967294-x", "1.2.4294967295", "1.4294967295.0",
+    "1.4294967295.1",
+};
+
+void test_semverreq_compiled(void) {
+  semver_version_req_compiled c;
+  semver_version_key k;
+  semver_version_req r;
+  semver_version v;
+  size_t i, j;
+  int m;
+
+  for (i = 0; i < sizeof(compiled_reqs) / sizeof(compiled_reqs[0]); i++) {
+    r = semver_version_req_from_string(compiled_reqs[i]);
+    TEST_ASSERT_NOT_NULL(r);
+    semver_version_req_compile(r, &c);
+    for (j = 0; j < sizeof(compiled_versions) / sizeof(compiled_versions[0]);
+         j++) {
+      v = semver_version_from_string(compiled_versions[j]);
+      TEST_ASSERT_NOT_NULL(v);
+      k = semver_version_key_of(v);
+      m = semver_version_req_compiled_match_key(&c, &k);
+      if (m != SEMVERREQ_UNDECIDED) {
+        TEST_ASSERT_EQUAL(semver_version_req_matches(r, v), m);
+      }
+      TEST_ASSERT_EQUAL(semver_version_req_matches(r, v),
+                        semver_version_req_compiled_matches(&c, r, v));
+      semver_version_delete(v);
+    }
+    semver_version_req_delete(r);
+  }
+
+  /* bounds without prerelease decide by keys alone */
+  r = semver_version_req_from_string(">=1.0.0 <2.0.0");
+  semver_version_req_compile(r, &c);
+  for (j = 0; j < sizeof(compiled_versions) / sizeof(compiled_versions[0]);
+       j++) {
+    v = semver_version_from_string(compiled_versions[j]);
+    k = semver_version_key_of(v);
+    TEST_ASSERT_NOT_EQUAL(SEMVERREQ_UNDECIDED,
+                          semver_version_req_compiled_match_key(&c, &k));
+    semver_version_delete(v);
+  }
+  semver_version_req_delete(r);
+}
+
+void test_semverreq_matches_many(void) {
+  semver_version vs[600];
+  semver_version_key keys[600];
+  unsigned char bitmap[SEMVERREQ_BITMAP_SIZE(600) + 1];
+  semver_version_req r;
+  char buf[64];
+  size_t i, j, n, cnt, expect;
+
+  for (i = 0; i < 600; i++) {
+    j = i % (sizeof(compiled_versions) / sizeof(compiled_versions[0]));
+    if (i < 100) {
+      vs[i] = semver_version_from_string(compiled_versions[j]);
+    } else {
+      sprintf(buf, "%lu.%lu.%lu%s", (unsigned long)(i % 4),
+              (unsigned long)(i % 5), (unsigned long)(i % 6),
+              i % 7 ? "" : "-rc.1");
+      vs[i] = semver_version_from_string(buf);
+    }
+    keys[i] = semver_version_key_of(vs[i]);
+  }
+
+  for (i = 0; i < sizeof(compiled_reqs) / sizeof(compiled_reqs[0]); i++) {
+    r = semver_version_req_from_string(compiled_reqs[i]);
+    /* odd lengths leave unused bits in the last byte */
+    for (n = 595; n <= 600; n += 5) {
+      memset(bitmap, 0xff, sizeof(bitmap));
+      cnt = semver_version_req_matches_many(r, vs, n, bitmap);
+      expect = 0;
+      for (j = 0; j < n; j++) {
+        TEST_ASSERT_EQUAL(semver_version_req_matches(r, vs[j]),
+                          (bitmap[j / 8] >> (j % 8)) & 1);
+        expect += semver_version_req_matches(r, vs[j]);
+      }
+      TEST_ASSERT_EQUAL(expect, cnt);
+      for (j = n; j < SEMVERREQ_BITMAP_SIZE(n) * 8; j++) {
+        TEST_ASSERT_EQUAL(0, (bitmap[j / 8] >> (j % 8)) & 1);
+      }
+      TEST_ASSERT_EQUAL(0xff, bitmap[SEMVERREQ_BITMAP_SIZE(n)]);
+
+      memset(bitmap, 0, sizeof(bitmap));
+      TEST_ASSERT_EQUAL(expect,
+                        semver_version_req_matches_keys(r, keys, vs, n, bitmap));
+      for (j = 0; j < n; j++) {
+        TEST_ASSERT_EQUAL(semver_version_req_matches(r, vs[j]),
+                          (bitmap[j / 8] >> (j % 8)) & 1);
+      }
+      TEST_ASSERT_EQUAL(expect,
+                        semver_version_req_matches_many(r, vs, n, NULL));
+    }
+    semver_version_req_delete(r);
+  }
+
+  for (i = 0; i < 600; i++) {
+    semver_version_delete(vs[i]);
+  }
+}
+
 void run_semverreq_tests(void) {
   /* explicitly constructed semverreqs should print correctly */
   RUN_TEST(test_semverreq_print);
@@ -387,4 +627,13 @@ void run_semverreq_tests(void) {
   RUN_TEST(test_semverreq_match_range);
   RUN_TEST(test_semverreq_match_range_ops);
   RUN_TEST(test_semverreq_match_invalid);
+  RUN_TEST(test_semverreq_compiled);
+  RUN_TEST(test_semverreq_matches_many);
+
+  /* requirements in caller-provided storage */
+  RUN_TEST(test_semverreq_strn);
+  RUN_TEST(test_semverreq_storage);
+
+  /* allocation failures must be reported */
+  RUN_TEST(test_semverreq_out_of_memory);
 }
@@ -0,0 +1,176 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "semver.h"
+#include "semverreq.h"
+#include "semverreqindex.h"
+
+#include "unity.h"
+
+#define REQINDEX_N_VERSIONS 60
+#define REQINDEX_N_REQS 600
+
+static const char *reqindex_ops[] = {">=", ">", "<=", "<", "=", "^", "~"};
+
+/* the i-th version of the test universe */
+void reqindex_version(char *buf, unsigned long i) {
+  sprintf(buf, "%lu.%lu.%lu%s", i % 3, (i / 3) % 4, (i / 12) % 5,
+          i % 7 == 3 ? "-rc.1" : (i % 11 == 5 ? "-alpha" : ""));
+}
+
+/* counts how often r occurs in out[0..n) */
+size_t reqindex_occurrences(semver_version_req *out, size_t n,
+                            semver_version_req r) {
+  size_t i, c = 0;
+
+  for (i = 0; i < n; i++) {
+    c += out[i] == r;
+  }
+  return c;
+}
+
+/* checks stabbing queries of all versions against matching each live
+ * requirement */
+void reqindex_check(semver_req_index idx, semver_version *vs,
+                    semver_version_req *reqs, const int *live) {
+  semver_version_req out[REQINDEX_N_REQS];
+  size_t i, j, k, expect;
+
+  for (i = 0; i < REQINDEX_N_VERSIONS; i++) {
+    k = semver_req_index_stab(idx, vs[i], out, REQINDEX_N_REQS);
+    expect = 0;
+    for (j = 0; j < REQINDEX_N_REQS; j++) {
+      if (live[j]) {
+        TEST_ASSERT_EQUAL(semver_version_req_matches(reqs[j], vs[i]),
+                          reqindex_occurrences(out, k, reqs[j]));
+        expect += semver_version_req_matches(reqs[j], vs[i]);
+      }
+    }
+    TEST_ASSERT_EQUAL(expect, k);
+    /* the count does not depend on the capacity of out */
+    TEST_ASSERT_EQUAL(k, semver_req_index_stab(idx, vs[i], out, 1));
+    TEST_ASSERT_EQUAL(k, semver_req_index_stab(idx, vs[i], NULL, 0));
+  }
+}
+
+void test_semverreqindex_stab(void) {
+  semver_version vs[REQINDEX_N_VERSIONS];
+  semver_version_req reqs[REQINDEX_N_REQS];
+  int live[REQINDEX_N_REQS];
+  semver_req_index idx;
+  char buf[64], a[32], b[32];
+  size_t i, n_live = 0;
+
+  srand(7);
+  for (i = 0; i < REQINDEX_N_VERSIONS; i++) {
+    reqindex_version(buf, i);
+    vs[i] = semver_version_from_string(buf);
+  }
+  for (i = 0; i < REQINDEX_N_REQS; i++) {
+    reqindex_version(a, rand() % REQINDEX_N_VERSIONS);
+    reqindex_version(b, rand() % REQINDEX_N_VERSIONS);
+    if (i % 3 == 0) {
+      sprintf(buf, "%s%s", reqindex_ops[rand() % 7], a);
+    } else {
+      /* includes empty ranges */
+      sprintf(buf, "%s%s %s%s", reqindex_ops[rand() % 2], a,
+              reqindex_ops[2 + rand() % 2], b);
+    }
+    reqs[i] = semver_version_req_from_string(buf);
+    TEST_ASSERT_NOT_NULL(reqs[i]);
+    live[i] = 0;
+  }
+
+  idx = semver_req_index_new();
+  TEST_ASSERT_NOT_NULL(idx);
+  reqindex_check(idx, vs, reqs, live);
+
+  for (i = 0; i < REQINDEX_N_REQS; i++) {
+    TEST_ASSERT_EQUAL(SEMVER_OK, semver_req_index_insert(idx, reqs[i]));
+    live[i] = 1;
+    n_live++;
+    if (i % 97 == 0) {
+      reqindex_check(idx, vs, reqs, live);
+    }
+  }
+  TEST_ASSERT_EQUAL(n_live, semver_req_index_count(idx));
+  reqindex_check(idx, vs, reqs, live);
+
+  /* remove most, in an order unrelated to insertion; removed requirements
+   * are freed right away */
+  for (i = 0; i < REQINDEX_N_REQS; i++) {
+    size_t j = (i * 7) % REQINDEX_N_REQS;
+    if (j % 5 != 0) {
+      TEST_ASSERT_EQUAL(1, semver_req_index_remove(idx, reqs[j]));
+      TEST_ASSERT_EQUAL(0, semver_req_index_remove(idx, reqs[j]));
+      semver_version_req_delete(reqs[j]);
+      live[j] = 0;
+      n_live--;
+      if (i % 101 == 0) {
+        reqindex_check(idx, vs, reqs, live);
+      }
+    }
+  }
+  TEST_ASSERT_EQUAL(n_live, semver_req_index_count(idx));
+  reqindex_check(idx, vs, reqs, live);
+
+  /* inserting twice reports twice */
+  TEST_ASSERT_EQUAL(SEMVER_OK, semver_req_index_insert(idx, reqs[0]));
+  {
+    semver_version_req out[REQINDEX_N_REQS];
+    size_t k = semver_req_index_stab(idx, vs[0], out, REQINDEX_N_REQS);
+    TEST_ASSERT_EQUAL(2 * semver_version_req_matches(reqs[0], vs[0]),
+                      reqindex_occurrences(out, k, reqs[0]));
+  }
+  TEST_ASSERT_EQUAL(1, semver_req_index_remove(idx, reqs[0]));
+  reqindex_check(idx, vs, reqs, live);
+
+  semver_req_index_delete(idx);
+  for (i = 0; i < REQINDEX_N_REQS; i++) {
+    if (live[i]) {
+      semver_version_req_delete(reqs[i]);
+    }
+  }
+  for (i = 0; i < REQINDEX_N_VERSIONS; i++) {
+    semver_version_delete(vs[i]);
+  }
+}
+
+void test_semverreqindex_sequential(void) {
+  semver_version_req *reqs = malloc(3000 * sizeof(semver_version_req));
+  semver_version_req out[4];
+  semver_req_index idx = semver_req_index_new();
+  semver_version v;
+  char buf[64];
+  size_t i;
+
+  /* disjoint, ascending ranges would degenerate an unbalanced tree */
+  for (i = 0; i < 3000; i++) {
+    sprintf(buf, ">=%lu.0.0 <%lu.0.0", (unsigned long)i,
+            (unsigned long)i + 1);
+    reqs[i] = semver_version_req_from_string(buf);
+    TEST_ASSERT_EQUAL(SEMVER_OK, semver_req_index_insert(idx, reqs[i]));
+  }
+  for (i = 0; i < 3000; i += 7) {
+    sprintf(buf, "%lu.5.0", (unsigned long)i);
+    v = semver_version_from_string(buf);
+    TEST_ASSERT_EQUAL(1, semver_req_index_stab(idx, v, out, 4));
+    TEST_ASSERT_EQUAL_PTR(reqs[i], out[0]);
+    semver_version_delete(v);
+  }
+  v = semver_version_from_string("3000.0.0");
+  TEST_ASSERT_EQUAL(0, semver_req_index_stab(idx, v, out, 4));
+  semver_version_delete(v);
+
+  semver_req_index_delete(idx);
+  for (i = 0; i < 3000; i++) {
+    semver_version_req_delete(reqs[i]);
+  }
+  free(reqs);
+}
+
+void run_semverreqindex_tests(void) {
+  RUN_TEST(test_semverreqindex_stab);
+  RUN_TEST(test_semverreqindex_sequential);
+}
@@ -0,0 +1,77 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "semver.h"
+
+#include "unity.h"
+
+/* white-box test */
+extern size_t semver_scan_span(const char *s, size_t n, int cls,
+                               size_t *dots);
+extern size_t semver_scan_span_scalar(const char *s, size_t n, int cls,
+                                      size_t *dots);
+
+#define SCAN_LEN 80
+
+/* compares vector and scalar scans of all prefixes of buf */
+void assert_scan_equal(const char *buf, size_t n) {
+  size_t k, a, b, da, db;
+  int cls;
+
+  for (cls = 0; cls < 2; cls++) {
+    for (k = 0; k <= n; k++) {
+      da = db = 0;
+      a = semver_scan_span(buf, k, cls, &da);
+      b = semver_scan_span_scalar(buf, k, cls, &db);
+      TEST_ASSERT_EQUAL(b, a);
+      TEST_ASSERT_EQUAL(db, da);
+    }
+  }
+}
+
+void test_semverscan_span(void) {
+  const char *sha = "sha.4f1b2c3d4e5f60718293a4b5c6d7e8f9.ci-20230401T120000";
+  size_t dots = 0;
+
+  TEST_ASSERT_EQUAL(strlen(sha), semver_scan_span(sha, strlen(sha), 0, &dots));
+  TEST_ASSERT_EQUAL(2, dots);
+
+  dots = 0;
+  TEST_ASSERT_EQUAL(4, semver_scan_span("rc.1+b.2", 8, 0, &dots));
+  TEST_ASSERT_EQUAL(1, dots);
+  /* '+' is part of the version class */
+  TEST_ASSERT_EQUAL(8, semver_scan_span("rc.1+b.2 <2.0.0", 15, 1, NULL));
+  TEST_ASSERT_EQUAL(0, semver_scan_span("", 0, 0, NULL));
+}
+
+void test_semverscan_vector_scalar(void) {
+  char buf[SCAN_LEN];
+  size_t i, pos;
+  int c;
+
+  /* every byte value at every position of a valid input */
+  for (pos = 0; pos < SCAN_LEN; pos += 7) {
+    for (c = 0; c < 256; c++) {
+      for (i = 0; i < SCAN_LEN; i++) {
+        buf[i] = "ab.9Z-"[i % 6];
+      }
+      buf[pos] = (char)c;
+      assert_scan_equal(buf, SCAN_LEN);
+    }
+  }
+
+  /* random inputs, mostly valid */
+  srand(42);
+  for (i = 0; i < 200; i++) {
+    for (pos = 0; pos < SCAN_LEN; pos++) {
+      c = rand() % 40;
+      buf[pos] = "0123456789abcdefghijklmnopqrsXYZ.-+\x80 ~_\t"[c];
+    }
+    assert_scan_equal(buf, SCAN_LEN);
+  }
+}
+
+void run_semverscan_tests(void) {
+  RUN_TEST(test_semverscan_span);
+  RUN_TEST(test_semverscan_vector_scalar);
+}
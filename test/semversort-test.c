@@ -0,0 +1,204 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "semver.h"
+#include "semverreq.h"
+#include "semversort.h"
+
+#include "unity.h"
+
+#define SORT_N 5000
+
+/* random version, build metadata holds its index to check stability */
+void sort_random_version(char *buf, size_t i) {
+  const char *pre[] = {"", "-alpha", "-alpha.1", "-beta", "-rc.1", "-rc.11",
+                       "-rc.2", "-1", "-0.3"};
+  unsigned long ma = rand() % 4;
+  /* some large values, beyond the packed fields of keys */
+  if (rand() % 50 == 0) {
+    ma = 4294967295UL - rand() % 2;
+  }
+  sprintf(buf, "%lu.%d.%d%s+%lu", ma, rand() % 3, rand() % 300,
+          pre[rand() % 9], (unsigned long)i);
+}
+
+size_t sort_index_of(const semver_version v) {
+  char buf[SEMVER_MAXLEN];
+  semver_version_copy_build(v, buf, sizeof(buf));
+  return (size_t)strtoul(buf, NULL, 10);
+}
+
+void assert_sorted(const semver_version *arr, size_t n, int stable) {
+  size_t i;
+  int c;
+
+  for (i = 1; i < n; i++) {
+    c = semver_version_cmp(arr[i - 1], arr[i]);
+    TEST_ASSERT_TRUE(c <= 0);
+    if (c == 0 && stable) {
+      TEST_ASSERT_TRUE(sort_index_of(arr[i - 1]) < sort_index_of(arr[i]));
+    }
+  }
+}
+
+void test_semversort_versions(void) {
+  static semver_version arr[SORT_N];
+  char buf[SEMVER_MAXLEN];
+  size_t sizes[] = {0, 1, 2, 10, 23, 24, 100, SORT_N};
+  size_t i, s, n;
+
+  srand(7);
+  for (s = 0; s < sizeof(sizes) / sizeof(size_t); s++) {
+    n = sizes[s];
+    for (i = 0; i < n; i++) {
+      sort_random_version(buf, i);
+      arr[i] = semver_version_from_string(buf);
+      TEST_ASSERT_NOT_NULL(arr[i]);
+    }
+    TEST_ASSERT_EQUAL(SEMVER_OK, semver_version_sort(arr, n));
+    assert_sorted(arr, n, 1);
+    for (i = 0; i < n; i++) {
+      semver_version_delete(arr[i]);
+    }
+  }
+}
+
+void test_semversort_unique(void) {
+  const char *inp[] = {"1.0.0+b", "0.1.0", "1.0.0-rc.1", "1.0.0", "0.1.0",
+                       "1.0.0+a", "2.0.0"};
+  const char *exp[] = {"0.1.0", "1.0.0-rc.1", "1.0.0+b", "2.0.0",
+                       /* dropped duplicates */
+                       "0.1.0", "1.0.0", "1.0.0+a"};
+  const size_t n = sizeof(inp) / sizeof(const char *);
+  semver_version arr[sizeof(inp) / sizeof(const char *)];
+  char buf[SEMVER_MAXLEN];
+  size_t i, u;
+
+  for (i = 0; i < n; i++) {
+    arr[i] = semver_version_from_string(inp[i]);
+  }
+  TEST_ASSERT_EQUAL(SEMVER_OK, semver_version_sort_flags(
+                                   arr, n, SEMVER_SORT_UNIQUE, &u));
+  TEST_ASSERT_EQUAL(4, u);
+  for (i = 0; i < n; i++) {
+    semver_version_sprint(arr[i], buf);
+    TEST_ASSERT_EQUAL_STRING(exp[i], buf);
+    semver_version_delete(arr[i]);
+  }
+}
+
+void test_semversort_strings(void) {
+  const char *strs[] = {"1.10.0", "x.y.z", "1.2.0", "1.9.0-beta", "",
+                        "1.9.0", "1.2.0", "01.0.0", "0.0.1"};
+  const char *exp[] = {"0.0.1", "1.2.0", "1.9.0-beta", "1.9.0", "1.10.0",
+                       "1.2.0", "x.y.z", "", "01.0.0"};
+  const size_t n = sizeof(strs) / sizeof(const char *);
+  size_t i, u;
+
+  TEST_ASSERT_EQUAL(SEMVER_OK, semver_version_sort_strings(
+                                   strs, n, SEMVER_SORT_UNIQUE, &u));
+  TEST_ASSERT_EQUAL(5, u);
+  for (i = 0; i < n; i++) {
+    TEST_ASSERT_EQUAL_STRING(exp[i], strs[i]);
+  }
+  TEST_ASSERT_EQUAL(SEMVER_OK, semver_version_sort_strings(strs, 0, 0, &u));
+  TEST_ASSERT_EQUAL(0, u);
+}
+
+void test_semversort_parallel(void) {
+  const unsigned int threads[] = {1, 2, 3, 8, 1000};
+  const size_t n = 50000;
+  semver_version *orig, *serial, *arr;
+  char buf[SEMVER_MAXLEN];
+  size_t i, t, u_serial, u;
+  int flags;
+
+  orig = malloc(3 * n * sizeof(semver_version));
+  TEST_ASSERT_NOT_NULL(orig);
+  serial = orig + n;
+  arr = serial + n;
+  srand(11);
+  for (i = 0; i < n; i++) {
+    sort_random_version(buf, i);
+    orig[i] = semver_version_from_string(buf);
+  }
+
+  for (flags = 0; flags <= SEMVER_SORT_UNIQUE; flags++) {
+    memcpy(serial, orig, n * sizeof(semver_version));
+    TEST_ASSERT_EQUAL(SEMVER_OK,
+                      semver_version_sort_flags(serial, n, flags, &u_serial));
+    assert_sorted(serial, u_serial, flags == 0);
+    for (t = 0; t < sizeof(threads) / sizeof(unsigned int); t++) {
+      memcpy(arr, orig, n * sizeof(semver_version));
+      TEST_ASSERT_EQUAL(SEMVER_OK, semver_version_sort_parallel(
+                                       arr, n, flags, &u, threads[t]));
+      TEST_ASSERT_EQUAL(u_serial, u);
+      TEST_ASSERT_EQUAL_MEMORY(serial, arr, n * sizeof(semver_version));
+    }
+  }
+
+  for (i = 0; i < n; i++) {
+    semver_version_delete(orig[i]);
+  }
+  free(orig);
+}
+
+void test_semversort_req_range(void) {
+  static semver_version arr[SORT_N];
+  static semver_version_key keys[SORT_N];
+  const char *reqs[] = {"^1.2.0",        ">=2.0.0-rc.1", "<1.0.0",
+                        "=3.1.7-beta",   "~0.2.5",       ">3.0.0 <=3.2.0",
+                        ">=4294967294.0.0", ">=5.0.0",    "<0.0.0"};
+  char buf[SEMVER_MAXLEN];
+  semver_version_req r;
+  size_t i, j, n = 1000, begin, end, b2, e2, cnt;
+
+  srand(11);
+  for (i = 0; i < n; i++) {
+    sort_random_version(buf, i);
+    arr[i] = semver_version_from_string(buf);
+  }
+  TEST_ASSERT_EQUAL(SEMVER_OK, semver_version_sort(arr, n));
+  for (i = 0; i < n; i++) {
+    keys[i] = semver_version_key_of(arr[i]);
+  }
+
+  for (i = 0; i < sizeof(reqs) / sizeof(reqs[0]); i++) {
+    r = semver_version_req_from_string(reqs[i]);
+    TEST_ASSERT_NOT_NULL(r);
+    cnt = semver_version_req_range(r, arr, n, &begin, &end);
+    TEST_ASSERT_EQUAL(end - begin, cnt);
+    for (j = 0; j < n; j++) {
+      TEST_ASSERT_EQUAL(semver_version_req_matches(r, arr[j]),
+                        begin <= j && j < end);
+    }
+    TEST_ASSERT_EQUAL(cnt,
+                      semver_version_req_range_keyed(r, arr, keys, n, &b2, &e2));
+    TEST_ASSERT_EQUAL(begin, b2);
+    TEST_ASSERT_EQUAL(end, e2);
+    semver_version_req_delete(r);
+  }
+
+  /* bounds of the array's own versions */
+  for (i = 0; i < n; i += 37) {
+    begin = semver_version_lower_bound(arr, n, arr[i]);
+    end = semver_version_upper_bound(arr, n, arr[i]);
+    TEST_ASSERT(begin <= i && i < end);
+    TEST_ASSERT(begin == 0 || semver_version_cmp(arr[begin - 1], arr[i]) < 0);
+    TEST_ASSERT(end == n || semver_version_cmp(arr[end], arr[i]) > 0);
+  }
+  TEST_ASSERT_EQUAL(0, semver_version_lower_bound(arr, 0, arr[0]));
+
+  for (i = 0; i < n; i++) {
+    semver_version_delete(arr[i]);
+  }
+}
+
+void run_semversort_tests(void) {
+  RUN_TEST(test_semversort_versions);
+  RUN_TEST(test_semversort_unique);
+  RUN_TEST(test_semversort_strings);
+  RUN_TEST(test_semversort_parallel);
+  RUN_TEST(test_semversort_req_range);
+}
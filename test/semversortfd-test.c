@@ -0,0 +1,176 @@
+/* mkstemp, lseek, unlink and setrlimit are POSIX */
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include "semver.h"
+#include "semversort.h"
+
+#include "unity.h"
+
+#define SORTFD_N 30000
+
+/* opens an unlinked temporary file */
+int sortfd_tmpfile(void) {
+  char path[] = "/tmp/semver-sortfd-test-XXXXXX";
+  int fd = mkstemp(path);
+  TEST_ASSERT_TRUE(fd >= 0);
+  unlink(path);
+  return fd;
+}
+
+/* reads all of fd into a new, NUL-terminated buffer */
+char *sortfd_read_all(int fd) {
+  size_t cap = 4096, len = 0;
+  char *buf = malloc(cap);
+  ssize_t k;
+
+  lseek(fd, 0, SEEK_SET);
+  while ((k = read(fd, buf + len, cap - len - 1)) > 0) {
+    len += k;
+    if (cap - len < 2) {
+      cap *= 2;
+      buf = realloc(buf, cap);
+    }
+  }
+  buf[len] = '\0';
+  return buf;
+}
+
+/* checks output of semver_version_sort_fd against semver_version_sort_strings
+ * of the same lines */
+void sortfd_check(char **lines, size_t n, size_t budget, int flags) {
+  semver_sort_fd_options opts;
+  const char **sorted;
+  char *out, *p;
+  size_t i, u, written;
+  int in_fd, out_fd;
+
+  in_fd = sortfd_tmpfile();
+  out_fd = sortfd_tmpfile();
+  for (i = 0; i < n; i++) {
+    TEST_ASSERT_EQUAL(strlen(lines[i]), write(in_fd, lines[i], strlen(lines[i])));
+    TEST_ASSERT_EQUAL(1, write(in_fd, "\n", 1));
+  }
+  lseek(in_fd, 0, SEEK_SET);
+
+  memset(&opts, 0, sizeof(opts));
+  opts.mem_budget = budget;
+  opts.flags = flags;
+  TEST_ASSERT_EQUAL(SEMVER_OK,
+                    semver_version_sort_fd(in_fd, out_fd, &opts, &written));
+
+  sorted = malloc(n * sizeof(const char *));
+  memcpy(sorted, lines, n * sizeof(const char *));
+  TEST_ASSERT_EQUAL(SEMVER_OK, semver_version_sort_strings(sorted, n, flags, &u));
+  TEST_ASSERT_EQUAL(u, written);
+
+  out = sortfd_read_all(out_fd);
+  p = out;
+  for (i = 0; i < u; i++) {
+    TEST_ASSERT_EQUAL_MEMORY(sorted[i], p, strlen(sorted[i]));
+    p += strlen(sorted[i]);
+    TEST_ASSERT_EQUAL('\n', *p++);
+  }
+  TEST_ASSERT_EQUAL('\0', *p);
+
+  free(out);
+  free(sorted);
+  close(in_fd);
+  close(out_fd);
+}
+
+void test_semversortfd_runs(void) {
+  const char *pre[] = {"", "-alpha", "-alpha.1", "-rc.1", "-rc.11", "-0.3"};
+  struct rlimit prev, lim;
+  char **lines;
+  size_t i;
+  int fd;
+
+  lines = malloc(SORTFD_N * sizeof(char *));
+  srand(3);
+  for (i = 0; i < SORTFD_N; i++) {
+    lines[i] = malloc(64);
+    sprintf(lines[i], "%d.%d.%d%s+%lu", rand() % 3, rand() % 5, rand() % 40,
+            pre[rand() % 6], (unsigned long)(i % 7));
+  }
+  /* in memory */
+  sortfd_check(lines, SORTFD_N, 0, 0);
+  /* spilled runs, merged in a single pass */
+  sortfd_check(lines, SORTFD_N, 1024 * 1024, 0);
+  sortfd_check(lines, SORTFD_N, 1024 * 1024, SEMVER_SORT_UNIQUE);
+  /* more runs than merged at once */
+  sortfd_check(lines, SORTFD_N, 32 * 1024, 0);
+  sortfd_check(lines, SORTFD_N, 32 * 1024, SEMVER_SORT_UNIQUE);
+
+  /* the number of open files does not grow with the number of runs */
+  fd = dup(0);
+  TEST_ASSERT_TRUE(fd >= 0);
+  close(fd);
+  TEST_ASSERT_EQUAL(0, getrlimit(RLIMIT_NOFILE, &prev));
+  lim = prev;
+  lim.rlim_cur = fd + 8;
+  TEST_ASSERT_EQUAL(0, setrlimit(RLIMIT_NOFILE, &lim));
+  sortfd_check(lines, SORTFD_N, 16 * 1024, 0);
+  TEST_ASSERT_EQUAL(0, setrlimit(RLIMIT_NOFILE, &prev));
+
+  for (i = 0; i < SORTFD_N; i++) {
+    free(lines[i]);
+  }
+  free(lines);
+}
+
+void test_semversortfd_lines(void) {
+  const char inp[] = "2.0.0\r\n\n1.0.0\ninvalid\n1.0.0-rc.1\n\n0.1.0";
+  semver_sort_fd_options opts;
+  char *long_line, *out;
+  size_t i, written;
+  int in_fd, out_fd;
+
+  in_fd = sortfd_tmpfile();
+  out_fd = sortfd_tmpfile();
+  /* a line longer than any buffer is dropped */
+  long_line = malloc(100000);
+  memset(long_line, '1', 99999);
+  long_line[99999] = '\n';
+  write(in_fd, long_line, 100000);
+  write(in_fd, inp, sizeof(inp) - 1);
+  lseek(in_fd, 0, SEEK_SET);
+
+  TEST_ASSERT_EQUAL(SEMVER_OK, semver_version_sort_fd(in_fd, out_fd, NULL, &written));
+  TEST_ASSERT_EQUAL(4, written);
+  out = sortfd_read_all(out_fd);
+  TEST_ASSERT_EQUAL_STRING("0.1.0\n1.0.0-rc.1\n1.0.0\n2.0.0\n", out);
+  free(out);
+
+  /* empty input */
+  ftruncate(in_fd, 0);
+  lseek(in_fd, 0, SEEK_SET);
+  close(out_fd);
+  out_fd = sortfd_tmpfile();
+  memset(&opts, 0, sizeof(opts));
+  opts.tmp_dir = "/nonexistent";
+  TEST_ASSERT_EQUAL(SEMVER_OK, semver_version_sort_fd(in_fd, out_fd, &opts, &written));
+  TEST_ASSERT_EQUAL(0, written);
+
+  /* spilling fails without a usable directory */
+  lseek(in_fd, 0, SEEK_SET);
+  for (i = 0; i < 2000; i++) {
+    write(in_fd, "1.2.3\n", 6);
+  }
+  lseek(in_fd, 0, SEEK_SET);
+  opts.mem_budget = 4096;
+  TEST_ASSERT_EQUAL(SEMVER_ERROR_IO, semver_version_sort_fd(in_fd, out_fd, &opts, NULL));
+
+  free(long_line);
+  close(in_fd);
+  close(out_fd);
+}
+
+void run_semversortfd_tests(void) {
+  RUN_TEST(test_semversortfd_runs);
+  RUN_TEST(test_semversortfd_lines);
+}